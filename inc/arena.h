@@ -24,15 +24,24 @@
 	// Arena
 	t_arena	*arena_find();
 	t_arena *arena_get();
+	void	arena_lock(t_arena *arena);
+	void	arena_migrate();
+	void	arena_release(void *arena);
 
 	// Heap
 	int		heap_can_removed(t_arena *arena, t_heap *src_heap);
 	t_heap	*heap_find(t_arena *arena, void *ptr);
 	void	*heap_create(t_arena *arena, int type, size_t size, size_t alignment);
+	void	*heap_remap(t_heap *heap, size_t size);
 	int		heap_destroy(t_heap *heap);
+	void	*heap_map(size_t *size, bool align);
 	void	heap_hist_extend();
 	void	heap_hist_destroy();
 
+	// Superblock
+	void	*superblock_take(t_arena *arena, size_t size, t_superblock **superblock, bool *dirty);
+	int		superblock_release(t_arena *arena, t_superblock *superblock, void *ptr, size_t size);
+
 	// Coalescing
 	int		link_chunk(t_chunk *chunk, t_arena *arena, t_heap *heap);
 	int		unlink_chunk(t_chunk *chunk, t_arena *arena, t_heap *heap);
@@ -41,12 +50,50 @@
 	// Bin
 	t_chunk	*split_top_chunk(t_heap *heap, size_t size);
 	void	*get_bestheap(t_arena *arena, int type, size_t size);
-	void	*find_memory(t_arena *arena, size_t size);
+	void	*find_memory(t_arena *arena, size_t size, bool *fresh);
+
+	// Slab
+	void	*slab_alloc(t_arena *arena, size_t size);
+	int		slab_check(void *ptr, t_heap *heap);
+	size_t	slab_usable(void *ptr, t_heap *heap);
+	int		slab_free(t_arena *arena, void *ptr, t_heap *heap);
+
+	// Cache
+	void	cache_flush();
+	void	cache_fill(t_arena *arena, size_t size);
+	void	cache_sync(t_arena *arena);
+	void	*cache_get(size_t size);
+	int		cache_put(void *ptr);
+	int		cache_put_sized(void *ptr, size_t size);
+
+	// Stats
+	void	stats_load(t_arena *arena, t_stats *stats);
+	int		stats_total(t_stats *total, size_t *retained);
+
+	// Latency
+	uint64_t	latency_ticks();
+	double	latency_scale();
+	bool	latency_sample();
+	int		latency_type(void *ptr);
+	void	latency_record(int op, int type, uint64_t ticks);
+	void	latency_release();
+	int		latency_total(t_latency *total);
+
+	// Profile
+	void	profile_alloc(void *ptr, size_t size);
+	void	profile_free(void *ptr);
 
 	// Allocate
 	int		check_digit(void *ptr1, void *ptr2);
-	void	*allocate_aligned(char *source, size_t alignment, size_t size);
-	void	*allocate_zero(char *source);
-	void	*allocate(char *source, size_t size);
+	void	*allocate_aligned(int source, size_t alignment, size_t size);
+	void	*allocate_zero(int source);
+	void	*allocate(int source, size_t size);
+	size_t	allocate_batch(int source, size_t size, size_t n, void **out);
+
+	// Free
+	void	remote_drain(t_arena *arena);
+	void	release_ptr(void *ptr);
+	void	release_batch(void **ptrs, size_t n);
+	void	release_sized(void *ptr, size_t size);
 
 #pragma endregion
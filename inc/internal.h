@@ -25,6 +25,7 @@
 	#include <dlfcn.h>
 	#include <fcntl.h>
 	#include <sys/mman.h>
+	#include <time.h>
 
 #pragma endregion
 
@@ -51,6 +52,10 @@
 	#define GET_FD(chunk)				*(void **)((char *)(chunk) + sizeof(t_chunk))															// Get forward pointer
 	#define SET_FD(chunk, next_chunk)	(*(void **)((char *)(chunk) + sizeof(t_chunk)) = (next_chunk))											// Set forward pointer
 
+	// --- BK ---
+	#define GET_BK(chunk)				*(void **)((char *)(chunk) + sizeof(t_chunk) + sizeof(void *))											// Get backward pointer
+	#define SET_BK(chunk, prev_chunk)	(*(void **)((char *)(chunk) + sizeof(t_chunk) + sizeof(void *)) = (prev_chunk))							// Set backward pointer
+
 	// --- CHUNK ---
 	#define GET_PTR(chunk)				(void *)((char *)(chunk) + sizeof(t_chunk))																// Get pointer to user data
 	#define GET_HEAD(chunk) 			(void *)((char *)(chunk) - sizeof(t_chunk))																// Get pointer to chunk header
@@ -75,15 +80,88 @@
 	#define IS_ALIGNED(ptr)				(((uintptr_t)GET_HEAD(ptr) & (ALIGNMENT - 1)) == 0)														// Check if header is properly aligned
 	#define ALIGN(size)					(((size) + (ALIGNMENT - 1)) & ~(ALIGNMENT - 1))															// Align size up to ALIGNMENT
 	#define ALIGN_UP(addr, align)		(((addr) + (align) - 1) & ~((align) - 1))																// Align address upwards to the nearest multiple of 'align'
+	#define MIN_CHUNK					ALIGN(sizeof(t_chunk) + (sizeof(void *) * 2) + sizeof(uint32_t))										// Smallest chunk (header, FD, BK and size of previous chunk)
+	#define CHUNK_SIZE(size)			((ALIGN((size) + sizeof(t_chunk)) < MIN_CHUNK) ? MIN_CHUNK : ALIGN((size) + sizeof(t_chunk)))			// Size of the chunk needed for 'size' bytes (header included)
 
 	// --- HEAP SIZES ---
 	#define TINY_CHUNK					128																										// Max size for tiny chunk (before was 512)
 	#define TINY_BLOCKS					128																										// Number of tiny chunks per HEAP
-	#define TINY_SIZE					(((TINY_BLOCKS * TINY_CHUNK) + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1))										// Total size of tiny heap, aligned to page
+	#define TINY_SIZE					(((TINY_BLOCKS * TINY_CHUNK) + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1))										// Size of the first tiny heap of an arena, aligned to page
 
 	#define SMALL_CHUNK					2048																									// Max size for small chunk (before was 4096)
 	#define SMALL_BLOCKS				128																										// Number of small chunks per HEAP
-	#define SMALL_SIZE					(((SMALL_BLOCKS * SMALL_CHUNK) + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1))										// Total size of small heap, aligned to page
+	#define SMALL_SIZE					(((SMALL_BLOCKS * SMALL_CHUNK) + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1))										// Size of the first small heap of an arena, aligned to page
+
+	#define MEDIUM_CHUNK				(256 * 1024)																							// Max size for medium chunk (default mmap threshold, LARGE above it)
+	#define MEDIUM_BLOCKS				8																										// Number of medium chunks per HEAP
+	#define MEDIUM_SIZE					(MEDIUM_BLOCKS * MEDIUM_CHUNK)																			// Size of the first medium heap of an arena (also the min size, so a chunk of MMAP_THRESHOLD_MAX always fits)
+
+	#define MMAP_THRESHOLD_MAX			(MEDIUM_SIZE / 2)																						// Max value of the mmap threshold (dynamic or set with M_MMAP_THRESHOLD)
+
+	#define HUGE_PAGE_SIZE				(2 * 1024 * 1024)																						// Size of a huge page (mappings from this size can use huge pages if enabled)
+
+	// --- SUPERBLOCKS ---
+	#define SUPERBLOCK_SIZE				HUGE_PAGE_SIZE																							// Size of a superblock (TINY/SMALL heaps are carved out of it, aligned to a huge page)
+	#define SUPERBLOCK_MAP_WORDS		((SUPERBLOCK_SIZE / 4096 + 63) / 64)																	// Words in the bitmap of used pages of a superblock
+
+	// --- PAGE MAP ---
+	#define PAGEMAP_SHIFT				12																										// Granularity of the page map (4 KiB)
+	#define PAGEMAP_BITS				((ARCHITECTURE == 64) ? 12 : 10)																		// Index bits used by the middle and leaf levels
+	#define PAGEMAP_ROOT				((ARCHITECTURE == 64) ? 4096 : 1)																		// Entries in the root level (covers 48 or 32 bits of address space)
+	#define PAGEMAP_SIZE				((size_t)1 << PAGEMAP_BITS)																				// Entries in a middle or leaf node
+
+	// --- SLAB ---
+	#define SLAB_SIZE					4096																									// Size of a slab (TINY heaps are split in slabs of one size class)
+	#define SLAB_CLASSES				(TINY_CHUNK / ALIGNMENT)																				// Number of size classes (one per ALIGNMENT step up to TINY_CHUNK)
+	#define SLAB_MAP_WORDS				((SLAB_SIZE / ALIGNMENT + 63) / 64)																		// Words in the bitmap of free objects of a slab
+	#define SLAB_CLASS(size)			((ALIGN(size) / ALIGNMENT) - 1)																			// Size class of a TINY request
+	#define GET_SLAB(ptr)				((t_slab *)((uintptr_t)(ptr) & ~(uintptr_t)(SLAB_SIZE - 1)))											// Get slab header of an object
+	#define SLAB_START(slab)			((char *)(slab) + ALIGN(sizeof(t_slab)))																// Get pointer to the first object of a slab
+	#define SLAB_BIT(ptr)				(((uintptr_t)(ptr) & (SLAB_SIZE - 1)) / ALIGNMENT)														// Bit of a slab object in the bitmap of cached objects (objects are at least ALIGNMENT bytes apart)
+	#define SLAB_CACHED(ptr)			(__atomic_load_n(&GET_SLAB(ptr)->cached[SLAB_BIT(ptr) / 64], __ATOMIC_RELAXED) & (1ULL << (SLAB_BIT(ptr) % 64)))// Check if a slab object is held in a thread cache
+	#define SET_SLAB_CACHED(ptr)		__atomic_fetch_or(&GET_SLAB(ptr)->cached[SLAB_BIT(ptr) / 64], 1ULL << (SLAB_BIT(ptr) % 64), __ATOMIC_RELAXED)// Mark a slab object as held in a thread cache (atomic, other threads can cache objects of the same slab)
+	#define CLEAR_SLAB_CACHED(ptr)		__atomic_fetch_and(&GET_SLAB(ptr)->cached[SLAB_BIT(ptr) / 64], ~(1ULL << (SLAB_BIT(ptr) % 64)), __ATOMIC_RELAXED)// Unmark a slab object that leaves the thread cache
+
+	// --- BINS ---
+	#define SMALL_BINS					(int)((SMALL_CHUNK + sizeof(t_chunk)) / ALIGNMENT)														// Bins of a single chunk size (one per ALIGNMENT step up to SMALL chunks)
+	#define MEDIUM_BINS					40																										// Bins of a range of sizes (4 per power of two, chunks sorted by size)
+	#define BINS						(SMALL_BINS + MEDIUM_BINS)																				// Number of bins of an arena
+	#define BINMAP_WORDS				((BINS + 63) / 64)																						// Words in the bitmap of non-empty bins (one bit per bin)
+
+	// --- ARENA ASSIGNMENT ---
+	#define ARENA_LOAD					64																										// Weight of each bound thread in the load of an arena (contended locks count as 1)
+	#define ARENA_MIGRATE				32																										// Contended locks (net of uncontended ones) after which a thread moves to a less loaded arena
+
+	// --- THREAD CACHE ---
+	#define CACHE_BINS					((SMALL_CHUNK + sizeof(t_chunk)) / ALIGNMENT)															// Number of cache bins (one per SMALL chunk size, slab classes go after them)
+	#define CACHE_COUNT					16																										// Max chunks per cache bin (half of them are returned to the arena when full)
+	#define CACHE_FILL					8																										// Max chunks moved from the arena bin to the cache on a miss
+
+	// --- STATISTICS ---
+	#define STATS_CLASSES				(ARCHITECTURE - 3)																						// Size classes of the statistics (one per power of two, from 16 bytes up to the max size_t)
+	#define STATS_CLASS(size)			(ARCHITECTURE - 4 - __builtin_clzl(((size) - 1) | 15))													// Size class of a block (up to 16 bytes is class 0, up to 32 bytes class 1...)
+	#define STATS_ADD(field, value)		__atomic_store_n(&(field), (field) + (value), __ATOMIC_RELAXED)											// Update a counter (the writer holds the arena lock, readers load it without locking)
+	#define STATS_SUB(field, value)		__atomic_store_n(&(field), (field) - (value), __ATOMIC_RELAXED)											// Update a counter (the writer holds the arena lock, readers load it without locking)
+
+	// --- LATENCY ---
+	#define LATENCY_OPS					3																										// Operations of the latency histograms (malloc, free and realloc)
+	#define LATENCY_PATHS				5																										// Internal paths of the latency histograms (cache, bin, top chunk, new heap and mmap)
+	#define LATENCY_BUCKETS				40																										// Buckets of a latency histogram (bucket i holds the samples from 2^(i-1) to 2^i ticks, the last one everything above)
+	#define LATENCY_BUCKET(ticks)		((ticks) ? 64 - __builtin_clzll(ticks) : 0)																// Bucket of a sample (0 ticks is bucket 0, 1 tick bucket 1, 2-3 ticks bucket 2...)
+
+	// --- TRACE ---
+	#define TRACE_EVENTS				8192																									// Events in the ring buffer of each thread (written to the trace file in one block when full)
+	#define TRACE_MAGIC					"FTMTRACE"																								// Magic bytes at the start of a trace file
+	#define TRACE_VERSION				2																										// Version of the trace file format
+	#define TRACE_SOURCES				{ "UNKOWN", "MALLOC", "CALLOC", "REALLOC", "REALLOC_ARRAY", "ALIGNED_ALLOC", "MEMALIGN", "POSIX_MEMALIGN", "VALLOC", "PVCALLOC", "MALLOC_BATCH" }// Names of the functions that allocate (indexed by SRC_*, the index is stored in the events)
+
+	// --- PROFILE ---
+	#define PROFILE_SAMPLES				65536																									// Live samples tracked by the heap profiler (a sample is dropped when its bucket is full)
+	#define PROFILE_WAYS				8																										// Slots of each bucket of the sample table (one cache line of pointers)
+	#define PROFILE_STACKS				4096																									// Different call stacks kept by the heap profiler
+	#define PROFILE_DEPTH				32																										// Max frames of a call stack
+	#define PROFILE_BUCKET(ptr)			(((((uintptr_t)(ptr) >> 4) * 0x9E3779B97F4A7C15ULL) >> 51) * PROFILE_WAYS)								// First slot of the bucket of a pointer (8192 buckets)
+	#define PROFILE_SAMPLED(size)		((thread_cache.profile_left -= (int64_t)(size)) < 0)													// Count the bytes of an allocation (true when the allocation has to be sampled)
 
 	// --- HEAP REMOVAL ---
 	#define FREE_PERCENT				10.0f																									// Max % of free memory in other heaps required to consider remove a heap
@@ -96,6 +174,7 @@
 	enum {
 		TINY,
 		SMALL,
+		MEDIUM,
 		LARGE,
 		MTX_INIT,
 		MTX_LOCK,
@@ -104,6 +183,44 @@
 		MTX_DESTROY
 	};
 
+	enum {
+		LAT_MALLOC,
+		LAT_FREE,
+		LAT_REALLOC
+	};
+
+	enum {
+		TRACE_ALLOC,
+		TRACE_FREE,
+		TRACE_EXTEND,
+		TRACE_SHRINK,
+		TRACE_SAME,
+		TRACE_HEAP_CREATE,
+		TRACE_HEAP_FREE
+	};
+
+	enum {
+		SRC_UNKNOWN,
+		SRC_MALLOC,
+		SRC_CALLOC,
+		SRC_REALLOC,
+		SRC_REALLOC_ARRAY,
+		SRC_ALIGNED_ALLOC,
+		SRC_MEMALIGN,
+		SRC_POSIX_MEMALIGN,
+		SRC_VALLOC,
+		SRC_PVALLOC,
+		SRC_MALLOC_BATCH
+	};
+
+	enum {
+		LAT_CACHE,
+		LAT_BIN,
+		LAT_TOP,
+		LAT_HEAP,
+		LAT_MMAP
+	};
+
 #pragma endregion
 
 #pragma region "Structures"
@@ -114,7 +231,7 @@
 	} t_chunk;
 
 	typedef struct s_heap_header {
-		uint8_t 		total;						// Max heap info that can be stored in a pagefile. A pagefile can store 73 or 85 heaps depending if there is arena info in that page
+		uint8_t 		total;						// Max heap info that can be stored in a pagefile (less if there is arena info in that page)
 		uint8_t 		used;						// Number of heap info stored
 		void			*next;						// Pointer to next heap header (in another pagefile)
 	} t_heap_header;
@@ -124,28 +241,158 @@
 		size_t			padding;					// Unused space used as padding for the user pointer so it is aligned (only used in LARGE heaps)
 		size_t			size;						// Size of the heap (not including padding)
 		size_t			free;						// Memory available for allocation in the heap (not including padding)
-		uint16_t		free_chunks;				// Number of free chunks in the heap
+		uint32_t		free_chunks;				// Number of free chunks in the heap
 		bool			active;						// Indicate if the heap is in used. Set to false when freed (used to detect double free)
-		int				type;						// Type of the heap (TINY, SMALL or LARGE)
-		t_chunk			*top_chunk;					// Pointer to the top chunk (unused memory at the end)
+		int				type;						// Type of the heap (TINY, SMALL, MEDIUM or LARGE)
+		t_chunk			*top_chunk;					// Pointer to the top chunk (unused memory at the end, first untouched slab in TINY heaps)
+		bool			retained;					// Empty heap kept mapped to be reused by heap_create() (not active)
+		bool			dirty;						// Memory reused from a retained heap (not zeroed by mmap)
+		void			*untouched;					// High-water mark of the memory handed out from the top chunk (after it, still zero from mmap)
+		uint64_t		retained_at;				// Time in ms when the heap was retained
+		void			*slabs;						// Unused slabs that can be given to any size class (only used in TINY heaps)
+		struct s_superblock	*superblock;			// Superblock that hosts the heap (NULL if the heap has its own mapping)
+		struct s_arena	*arena;						// Arena that owns the heap
 	} t_heap;
 
+	typedef struct s_slab {
+		struct s_slab	*next;						// Next slab of the same size class with free objects
+		struct s_slab	*prev;						// Previous slab of the same size class with free objects
+		t_heap			*heap;						// Heap that contains the slab
+		uint16_t		size;						// Size of the objects (0 = unused slab)
+		uint16_t		count;						// Number of objects in the slab
+		uint16_t		used;						// Number of objects in use
+		uint64_t		map[SLAB_MAP_WORDS];		// Bitmap of free objects (1 = free)
+		uint64_t		cached[SLAB_MAP_WORDS];		// Bitmap of objects held in a thread cache or a remote free list (1 = cached, indexed by SLAB_BIT)
+	} t_slab;
+
+	typedef struct s_superblock {
+		struct s_superblock	*next;					// Next superblock of the arena
+		struct s_superblock	*prev;					// Previous superblock of the arena
+		uint16_t		used;						// Number of pages in use (the first one is this header)
+		uint64_t		map[SUPERBLOCK_MAP_WORDS];	// Bitmap of used pages (1 = used)
+		uint64_t		dirty[SUPERBLOCK_MAP_WORDS];	// Bitmap of free pages that could not be zeroed (1 = not zero)
+	} t_superblock;
+
+	typedef struct s_stats {
+		size_t			in_use;						// Bytes handed out by the arena (usable size, chunks held in thread caches included)
+		size_t			mapped;						// Bytes mapped by the arena (own heap mappings and superblocks, retained heaps included)
+		size_t			large;						// Bytes mapped by active LARGE heaps
+		size_t			heaps[4];					// Active heaps of each type (TINY, SMALL, MEDIUM and LARGE)
+		size_t			allocs[STATS_CLASSES];		// Allocations of each size class
+		size_t			frees[STATS_CLASSES];		// Frees of each size class
+	} t_stats;
+
 	typedef struct s_arena {
 		int				id;							// Arena ID (0 = main thread)
 		int				alloc_count;				// Total number of allocations
 		int				free_count;					// Total number of frees
-		void			*bins[257];					// Bins
+		int				threads;					// Number of threads bound to the arena
+		uint32_t		contention;					// Recent contended locks (halved each time a thread is assigned)
+		void			*bins[BINS];				// Bins (exact size for SMALL chunks, sorted ranges for bigger ones)
+		uint64_t		binmap[BINMAP_WORDS];		// Bitmap of non-empty bins
+		t_slab			*slabs[SLAB_CLASSES];		// Slabs with free objects (one list per size class)
+		void			*remote_free;				// Chunks and slab objects freed by other threads (lock-free stack, drained by the owner)
 		t_heap_header	*heap_header;				// Pointer to the first heap header
-		struct s_arena	*next;          			// Pointer to the next arena
+		size_t			heap_size[3];				// Size of the next TINY, SMALL and MEDIUM heap (grows with each new heap)
+		size_t			retained;					// Bytes of empty heaps kept mapped for reuse
+		t_superblock	*superblocks;				// Superblocks that host the TINY/SMALL heaps of the arena
+		struct s_arena	*next;          			// Pointer to the next arena (append-only, published atomically)
 		pthread_mutex_t	mutex;          			// Arena mutex for thread safety
+		t_stats			stats;						// Counters updated under the arena lock and read without it (mallinfo2, malloc_stats, malloc_info)
 	} t_arena;
 
+	typedef struct s_latency {
+		struct s_latency	*next;					// Next histogram (append-only, published atomically)
+		int				used;						// Owned by a live thread (released on thread exit and reused by the next thread)
+		uint32_t		counts[LATENCY_OPS][4][LATENCY_PATHS][LATENCY_BUCKETS];	// Samples of each operation, heap type, path and bucket
+	} t_latency;
+
+	typedef struct s_trace_header {
+		char			magic[8];					// TRACE_MAGIC (not null-terminated)
+		uint32_t		version;					// TRACE_VERSION
+		uint32_t		event_size;					// Size of each event (sizeof(t_trace_event))
+	} t_trace_header;
+
+	typedef struct s_trace_event {
+		uint64_t		tsc;						// Ticks when the event happened (TSC, or ns on other architectures)
+		uint64_t		ptr;						// User pointer (start of the heap in heap events)
+		uint64_t		heap;						// Start of the heap of the pointer (0 for malloc(0) and pointers without a heap)
+		uint64_t		size;						// Requested size (size given to free_sized(), 0 for other frees)
+		uint32_t		thread;						// Thread ID (gettid)
+		uint16_t		arena;						// Arena of the thread
+		uint8_t			op;							// Event (TRACE_ALLOC, TRACE_FREE...)
+		uint8_t			info;						// Function of allocations and reallocs (SRC_*), heap type of heap events
+	} t_trace_event;
+
+	typedef struct s_trace {
+		struct s_trace	*next;						// Next ring buffer (append-only, published atomically)
+		int				used;						// Owned by a live thread (released on thread exit and reused by the next thread)
+		int				flushing;					// A thread is writing the buffer to the trace file
+		uint32_t		thread;						// Thread ID of the owner
+		size_t			head;						// Events written (only the owner writes them)
+		size_t			tail;						// Events flushed to the trace file
+		t_trace_event	events[TRACE_EVENTS];		// Ring buffer of events
+	} t_trace;
+
+	typedef struct s_profile_stack {
+		uint64_t		hash;						// Hash of the frames (0: free slot, 1: being written)
+		uint32_t		depth;						// Number of frames
+		size_t			live_count;					// Samples not freed yet
+		size_t			live_bytes;					// Bytes of the samples not freed yet
+		size_t			total_count;				// Samples since the start
+		size_t			total_bytes;				// Bytes of the samples since the start
+		void			*frames[PROFILE_DEPTH];		// Return addresses (the caller of the allocator first)
+	} t_profile_stack;
+
+	typedef struct s_profile_sample {
+		size_t			size;						// Requested size
+		uint32_t		stack;						// Call stack (index in stacks)
+	} t_profile_sample;
+
+	typedef struct s_profile {
+		uintptr_t		ptrs[PROFILE_SAMPLES];		// Pointer of each live sample (0: free slot, odd: being written)
+		t_profile_sample	samples[PROFILE_SAMPLES];	// Size and call stack of each live sample
+		uint8_t			used[PROFILE_SAMPLES / PROFILE_WAYS];	// Live samples in each bucket (free() only looks in the buckets that have some)
+		t_profile_stack	stacks[PROFILE_STACKS];		// Call stacks (open addressing)
+	} t_profile;
+
+	typedef struct s_cache {
+		void			*bins[CACHE_BINS + SLAB_CLASSES];	// Freed chunks and slab objects ready to be reused without locking (linked by forward pointer)
+		uint16_t		counts[CACHE_BINS + SLAB_CLASSES];	// Number of chunks in each cache bin
+		int				alloc_count;				// Allocations served by the cache (added to the arena on next lock)
+		int				free_count;					// Frees stored in the cache (added to the arena on next lock)
+		int				allocs[STATS_CLASSES];		// Allocations of each size class served by the cache (added to the arena on next lock)
+		int				frees[STATS_CLASSES];		// Frees of each size class stored in the cache (added to the arena on next lock)
+		uint64_t		classes;					// Bitmap of the size classes with counts not added to the arena yet
+		uint16_t		contended;					// Contended locks of the arena of the thread (net of uncontended ones, migrates at ARENA_MIGRATE)
+		t_latency		*latency;					// Latency histograms of the thread (created on the first sample)
+		uint32_t		samples;					// Calls since the last sample
+		bool			sampling;					// A sampled call is running (nested calls are not sampled)
+		uint8_t			path;						// Internal path taken by the last allocation or free (LAT_CACHE, LAT_BIN...)
+		t_trace			*trace;						// Trace ring buffer of the thread (created on the first event)
+		int64_t			profile_left;				// Bytes to allocate before the next heap profile sample
+		uint64_t		profile_seed;				// State of the random generator of the sampling intervals (0: not seeded)
+		bool			profiling;					// A sample is being taken (nested allocations are not sampled)
+	} t_cache;
+
 	typedef struct s_options {
 		int				MIN_USAGE;					// Heaps under this usage % are skipped (unless all are under)
 		int				CHECK_ACTION;				// Behaviour on abort errors (0: abort, 1: warning, 2: silence)
 		unsigned char	PERTURB;					// Sets memory to the PERTURB value on allocation, and to value ^ 255 on free
 		int				ARENA_TEST;					// Number of arenas at which a hard limit on arenas is computed
 		int				ARENA_MAX;					// Maximum number of arenas allowed
+		int				ARENA_CPU;					// Prefer the arena of the current CPU when several are equally loaded
+		int				HEAP_GROWTH;				// Each new TINY/SMALL/MEDIUM heap of an arena is this many times larger than the previous one (1: fixed size)
+		int				HEAP_MAX;					// Max size in MiB of a TINY/SMALL/MEDIUM heap
+		int				RETAIN_MAX;					// Max MiB of empty heaps kept mapped per arena (0: disabled)
+		int				RETAIN_DECAY;				// Time in ms an empty heap is kept mapped before being unmapped
+		int				HUGE_PAGES;					// Huge pages for mappings of HUGE_PAGE_SIZE or more (0: disabled, 1: transparent, 2: hugetlbfs)
+		int				MMAP_THRESHOLD;				// Requests above this size are served by mmap (-1: dynamic)
+		int				LATENCY;					// Sample one in this many malloc/free/realloc calls of each thread into the latency histograms (0: disabled)
+		int				TRACING;					// Writes a binary trace of allocations and frees to TRACEFILE (0: disabled, 1: enabled)
+		char			TRACEFILE[PATH_MAX];		// Trace file path
+		int				fd_trace;					// File descriptor of the trace file
+		int				PROFILE;					// Average bytes allocated between heap profile samples (0: disabled)
 		int				DEBUG;						// Enables debug mode (1: error, 2: system)
 		int				LOGGING;					// Enables logging mode (1: to file, 2: to stderr)
 		char 			LOGFILE[PATH_MAX];			// Log file path
@@ -156,12 +403,20 @@
 		int				arena_count;				// Number of arenas created
 		t_options		options;					// Global configuration options
 		t_arena			arena;						// Main arena (thread 0)
+		void			**pagemap[PAGEMAP_ROOT];	// Page map (root level), maps every heap page to its heap
+		size_t			mmap_threshold;				// Current mmap threshold (raised when LARGE chunks are freed, unless fixed by the user)
 		size_t			alloc_zero_counter;			// Counter for alloc calls
 		char			*hist_buffer;				// History buffer
 		size_t			hist_size;					// Size of history buffer
 		size_t			hist_pos;					// Current write position in history buffer
 		pthread_mutex_t	hist_mutex;					// History mutex for thread safety
-		pthread_mutex_t	mutex;						// Global mutex for thread safety
+		t_latency		*latency;					// Latency histograms of every thread (lock-free list)
+		uint64_t		latency_ticks;				// Ticks when the first histogram was created (converts ticks to ns)
+		uint64_t		latency_ns;					// Time in ns when the first histogram was created
+		t_trace			*trace;						// Trace ring buffers of every thread (lock-free list)
+		t_profile		*profile;					// Heap profile (created on the first sample)
+		pthread_key_t	thread_key;					// Key with a destructor that releases the arena and the cache of an exiting thread
+		pthread_mutex_t	mutex;						// Global mutex (arena creation and assignment)
 	} t_manager;
 
 #pragma endregion
@@ -169,6 +424,7 @@
 #pragma region "Variables"
 
 	extern __thread t_arena	*tcache;				// Thread-local arena
+	extern __thread t_cache	thread_cache;			// Thread-local chunk cache
 	extern t_manager		g_manager;				// Main structure
 
 #pragma endregion
@@ -185,8 +441,19 @@
 	void	ensure_init();
 	size_t	get_pagesize();
 
+	// Page Map
+	int		pagemap_set(void *ptr, size_t size, t_heap *heap);
+	t_heap	*pagemap_get(void *ptr);
+
 	// Options
 	void	options_initialize();
 	int		options_set(int param, int value);
 
+	// Trace
+	char	*trace_name(int source);
+	void	trace_event(int op, void *ptr, size_t size, int info);
+	void	trace_flush_all();
+	void	trace_release();
+	void	trace_fork();
+
 #pragma endregion
@@ -15,6 +15,7 @@
 #pragma region "Includes"
 
 	#include <stddef.h>
+	#include <stdio.h>
 
 #pragma endregion
 
@@ -22,9 +23,36 @@
 	#define M_ARENA_TEST		-7		// Number of arenas at which a hard limit on arenas is computed
 	#define M_PERTURB			-6		// Sets memory to the PERTURB value on allocation, and to value ^ 255 on free
 	#define M_CHECK_ACTION		-5		// Behaviour on abort errors (0: abort, 1: warning, 2: silence)
+	#define M_MMAP_THRESHOLD	-3		// Requests above this size are served by mmap (fixed, disables the dynamic threshold)
 	#define M_MIN_USAGE			 3		// Heaps under this usage % are skipped (unless all are under)
 	#define M_DEBUG				 7		// Enables debug mode (1: error, 2: system)
 	#define M_LOGGING			 8		// Enables logging mode (1: to file, 2: to stderr)
+	#define M_HEAP_GROWTH		 9		// Each new TINY/SMALL/MEDIUM heap is this many times larger than the previous one (1: fixed size)
+	#define M_HEAP_MAX			10		// Max size in MiB of a TINY/SMALL/MEDIUM heap
+	#define M_RETAIN_MAX		11		// Max MiB of empty heaps kept mapped per arena (0: disabled)
+	#define M_RETAIN_DECAY		12		// Time in ms an empty heap is kept mapped before being unmapped
+	#define M_HUGE_PAGES		13		// Huge pages for mappings of 2 MiB or more (0: disabled, 1: transparent, 2: hugetlbfs)
+	#define M_ARENA_CPU			14		// Prefer the arena of the current CPU when several are equally loaded
+	#define M_LATENCY			15		// Sample one in this many malloc/free/realloc calls into latency histograms (0: disabled)
+	#define M_TRACING			16		// Writes a binary trace of allocations and frees to MALLOC_TRACEFILE (0: disabled, 1: enabled)
+	#define M_PROFILE			17		// Average bytes allocated between heap profile samples (0: disabled)
+
+#pragma region "Structures"
+
+	struct mallinfo2 {
+		size_t	arena;		// Bytes mapped for heaps (not LARGE blocks)
+		size_t	ordblks;	// Number of free chunks (not tracked)
+		size_t	smblks;		// Number of fastbin blocks (not tracked)
+		size_t	hblks;		// Number of LARGE blocks (mmap)
+		size_t	hblkhd;		// Bytes mapped for LARGE blocks
+		size_t	usmblks;	// Unused (always 0)
+		size_t	fsmblks;	// Bytes in fastbin blocks (not tracked)
+		size_t	uordblks;	// Bytes in use
+		size_t	fordblks;	// Bytes mapped but not in use
+		size_t	keepcost;	// Bytes of empty heaps kept mapped for reuse
+	};
+
+#pragma endregion
 
 #pragma region "Methods"
 
@@ -42,11 +70,20 @@
 	size_t	malloc_usable_size(void *ptr);
 	void	*valloc(size_t size);
 	void	*pvalloc(size_t size);
+	void	free_sized(void *ptr, size_t size);
+	void	free_aligned_sized(void *ptr, size_t alignment, size_t size);
+	size_t	malloc_batch(size_t size, size_t n, void **out);
+	void	free_batch(void **ptrs, size_t n);
 
 	// Debug
 	int		mallopt(int param, int value);
 	void	show_alloc_mem();
 	void	show_alloc_mem_ex(void *ptr, size_t offset, size_t length);
 	void	show_alloc_history();
+	void	show_alloc_latency();
+	struct mallinfo2 mallinfo2();
+	void	malloc_stats();
+	int		malloc_info(int options, FILE *stream);
+	int		malloc_profile_dump(const char *path);
 
 #pragma endregion
@@ -20,6 +20,12 @@
 
 #pragma endregion
 
+#pragma region "Defines"
+
+	#define MEM_NT_THRESHOLD	(4 * 1024 * 1024)	// Fills and copies from this size use non-temporal stores (they bypass the cache)
+
+#pragma endregion
+
 #pragma region "Methods"
 
 	// STRING
@@ -38,8 +44,9 @@
 	int		is_power_of_two(size_t n);
 
 	// MEM
+	void	ft_mem_initialize();
 	void	*ft_memset(void *b, int c, size_t len);
-	void	*ft_memcpy(void *dst, const void *src, int n);
+	void	*ft_memcpy(void *dst, const void *src, size_t n);
 
 	// ATOMIC PRINTF
 	int		aprintf(int fd, int add_alloc_hist, char const *format, ...);
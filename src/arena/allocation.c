@@ -34,9 +34,7 @@
 
 #pragma region "Allocate Aligned"
 
-	void *allocate_aligned(char *source, size_t alignment, size_t size) {
-		if (!source || !*source) source = "UNKOWN";
-
+	void *allocate_aligned(int source, size_t alignment, size_t size) {
 		if (size > SIZE_MAX - sizeof(t_chunk)) { errno = ENOMEM; return (NULL); }
 
 		if (alignment < sizeof(void *) || !is_power_of_two(alignment)) {
@@ -52,17 +50,16 @@
 
 		void *ptr = NULL;
 
-		mutex(&tcache->mutex, MTX_LOCK);
+		arena_lock(tcache);
 
-			bool is_large = ALIGN(size + sizeof(t_chunk)) > SMALL_CHUNK + sizeof(t_chunk);
+			size_t	user_chunk_size = CHUNK_SIZE(size);
+			size_t	worst_case_total = (alignment - 1 + MIN_CHUNK) + user_chunk_size;
+			bool	is_large = size > __atomic_load_n(&g_manager.mmap_threshold, __ATOMIC_RELAXED) || worst_case_total > MMAP_THRESHOLD_MAX;
+			int		type = (worst_case_total > SMALL_CHUNK + sizeof(t_chunk)) ? MEDIUM : SMALL;
 
 			if (is_large) {
 				ptr = heap_create(tcache, LARGE, size, alignment);
 			} else {
-				size_t user_chunk_size = ALIGN(size + sizeof(t_chunk));
-				size_t worst_case_total = (alignment - 1 + sizeof(t_chunk) + sizeof(void *) + sizeof(uint32_t)) + user_chunk_size;
-
-				int type = (worst_case_total > TINY_CHUNK) ? SMALL : TINY;
 				t_heap *heap = get_bestheap(tcache, type, worst_case_total);
 				if (!heap) {
 					if (print_log(1))			aprintf(g_manager.options.fd_out, 1, "\t\t  [ERROR] Failed to allocated %u bytes\n", size);
@@ -75,7 +72,7 @@
 
 				if (!padding_needed) {
 					if (GET_SIZE(heap->top_chunk) < user_chunk_size) {
-						heap = heap_create(tcache, heap->type, (heap->type == TINY) ? TINY_SIZE : SMALL_SIZE, ALIGNMENT);
+						heap = heap_create(tcache, type, (type == SMALL) ? SMALL_SIZE : MEDIUM_SIZE, ALIGNMENT);
 						if (!heap) {
 							if (print_log(1))	aprintf(g_manager.options.fd_out, 1, "\t\t  [ERROR] Failed to allocated %u bytes\n", size);
 							mutex(&tcache->mutex, MTX_UNLOCK);
@@ -91,7 +88,7 @@
 					heap->free -= user_chunk_size;
 					ptr = GET_PTR(chunk);
 				} else {
-					size_t min_padding_size = sizeof(t_chunk) + sizeof(void *) + sizeof(uint32_t);
+					size_t min_padding_size = MIN_CHUNK;
 					if (padding_needed < min_padding_size) {
 						aligned_user_addr += ALIGN_UP(min_padding_size - padding_needed, alignment);
 						padding_needed = ((char *)aligned_user_addr - sizeof(t_chunk)) - (char *)heap->top_chunk;
@@ -99,7 +96,7 @@
 
 					size_t total_needed = padding_needed + user_chunk_size;
 					if (GET_SIZE(heap->top_chunk) < total_needed) {
-						heap = heap_create(tcache, heap->type, (heap->type == TINY) ? TINY_SIZE : SMALL_SIZE, ALIGNMENT);
+						heap = heap_create(tcache, type, (type == SMALL) ? SMALL_SIZE : MEDIUM_SIZE, ALIGNMENT);
 						if (!heap) {
 							if (print_log(1))	aprintf(g_manager.options.fd_out, 1, "\t\t  [ERROR] Failed to allocated %u bytes\n", size);
 							mutex(&tcache->mutex, MTX_UNLOCK);
@@ -133,16 +130,21 @@
 
 			if (ptr && g_manager.options.PERTURB) ft_memset(ptr, g_manager.options.PERTURB ^ 0xFF, GET_SIZE((t_chunk *)GET_HEAD(ptr)));
 
-			if (ptr && print_log(0))			aprintf(g_manager.options.fd_out, 1, "%p\t [%s] Allocated %u bytes\n", ptr, source, size);
+			if (ptr && print_log(0))			aprintf(g_manager.options.fd_out, 1, "%p\t [%s] Allocated %u bytes\n", ptr, trace_name(source), size);
 			if (!ptr && print_log(1))			aprintf(g_manager.options.fd_out, 1, "\t\t  [ERROR] Failed to allocated %u bytes\n", size);
+			if (ptr && g_manager.options.TRACING)	trace_event(TRACE_ALLOC, ptr, size, source);
 
 			if (ptr) {
 				SET_MAGIC(ptr);
 				tcache->alloc_count++;
+				STATS_ADD(tcache->stats.in_use, GET_SIZE((t_chunk *)GET_HEAD(ptr)));
+				STATS_ADD(tcache->stats.allocs[STATS_CLASS(GET_SIZE((t_chunk *)GET_HEAD(ptr)))], 1);
 			}
 
 		mutex(&tcache->mutex, MTX_UNLOCK);
 
+		if (ptr && g_manager.options.PROFILE && PROFILE_SAMPLED(size))	profile_alloc(ptr, size);
+
 		if (!ptr) errno = ENOMEM;
 		return (ptr);
 	}
@@ -151,9 +153,7 @@
 
 #pragma region "Allocate Zero"
 
-	void *allocate_zero(char *source) {
-		if (!source || !*source) source = "UNKOWN";
-
+	void *allocate_zero(int source) {
 		if (!arena_find()) {
 			if (print_log(1))		aprintf(g_manager.options.fd_out, 1, "\t\t  [ERROR] Failed to allocated 0 bytes\n");
 			errno = ENOMEM; return (NULL);
@@ -161,19 +161,15 @@
 
 		void *ptr = NULL;
 
-		mutex(&g_manager.mutex, MTX_LOCK);
-
-			size_t aligned_offset = (g_manager.alloc_zero_counter * ALIGNMENT);
-			g_manager.alloc_zero_counter++;
-
-		mutex(&g_manager.mutex, MTX_UNLOCK);
+		size_t aligned_offset = (__atomic_fetch_add(&g_manager.alloc_zero_counter, 1, __ATOMIC_RELAXED) * ALIGNMENT);
 
 		ptr = (void*)(ZERO_MALLOC_BASE + aligned_offset);
-		if (ptr && print_log(0))	aprintf(g_manager.options.fd_out, 1, "%p\t [%s] Allocated 0 bytes\n", ptr, source);
+		if (ptr && print_log(0))	aprintf(g_manager.options.fd_out, 1, "%p\t [%s] Allocated 0 bytes\n", ptr, trace_name(source));
 		if (!ptr && print_log(1))	aprintf(g_manager.options.fd_out, 1, "\t\t  [ERROR] Failed to allocated 0 bytes\n");
+		if (ptr && g_manager.options.TRACING)	trace_event(TRACE_ALLOC, ptr, 0, source);
 
 		if (ptr) {
-			mutex(&tcache->mutex, MTX_LOCK);
+			arena_lock(tcache);
 
 				tcache->alloc_count++;
 
@@ -186,11 +182,59 @@
 
 #pragma endregion
 
-#pragma region "Allocate"
+#pragma region "Allocate Batch"
+
+	size_t allocate_batch(int source, size_t size, size_t n, void **out) {
+		size_t count = 0;
+
+		// malloc(0) and LARGE blocks have nothing to share (one pointer or one mapping each)
+		if (!size || size > __atomic_load_n(&g_manager.mmap_threshold, __ATOMIC_RELAXED)) {
+			for (; count < n; ++count) if (!(out[count] = allocate(source, size))) break;
+			return (count);
+		}
+
+		if (size > SIZE_MAX - sizeof(t_chunk) || !arena_find()) {
+			if (print_log(1))			aprintf(g_manager.options.fd_out, 1, "\t\t  [ERROR] Failed to allocated %u bytes\n", size);
+			errno = ENOMEM; return (0);
+		}
+
+		bool is_tiny = size <= TINY_CHUNK;
 
-	void *allocate(char *source, size_t size) {
-		if (!source || !*source) source = "UNKOWN";
+		// One lock for the whole batch (consecutive chunks are carved from the same slab or top chunk)
+		arena_lock(tcache);
 
+			cache_sync(tcache);
+			for (; count < n; ++count) {
+				void *ptr = find_memory(tcache, size, NULL);
+				if (!ptr) break;
+				if (!is_tiny) SET_MAGIC(ptr);
+				out[count] = ptr;
+				STATS_ADD(tcache->stats.allocs[STATS_CLASS((is_tiny) ? ALIGN(size) : GET_SIZE((t_chunk *)GET_HEAD(ptr)))], 1);
+			}
+			tcache->alloc_count += count;
+
+		mutex(&tcache->mutex, MTX_UNLOCK);
+
+		for (size_t i = 0; i < count; ++i) {
+			if (g_manager.options.PERTURB) ft_memset(out[i], g_manager.options.PERTURB ^ 0xFF, (is_tiny) ? ALIGN(size) : GET_SIZE((t_chunk *)GET_HEAD(out[i])));
+			if (print_log(0))			aprintf(g_manager.options.fd_out, 1, "%p\t [%s] Allocated %u bytes\n", out[i], trace_name(source), size);
+			if (g_manager.options.TRACING)	trace_event(TRACE_ALLOC, out[i], size, source);
+			if (g_manager.options.PROFILE && PROFILE_SAMPLED(size))	profile_alloc(out[i], size);
+		}
+
+		if (count < n) {
+			if (print_log(1))			aprintf(g_manager.options.fd_out, 1, "\t\t  [ERROR] Failed to allocated %u bytes\n", size);
+			errno = ENOMEM;
+		}
+
+		return (count);
+	}
+
+#pragma endregion
+
+#pragma region "Allocate"
+
+	static void *allocate_memory(int source, size_t size) {
 		if (size > SIZE_MAX - sizeof(t_chunk)) {
 			if (print_log(1))			aprintf(g_manager.options.fd_out, 1, "\t\t  [ERROR] Failed to allocated %u bytes\n", size);
 			errno = ENOMEM; return (NULL);
@@ -202,30 +246,52 @@
 			errno = ENOMEM; return (NULL);
 		}
 
-		void *ptr = NULL;
+		bool is_large = size > __atomic_load_n(&g_manager.mmap_threshold, __ATOMIC_RELAXED);
+		bool is_tiny = size <= TINY_CHUNK;
+		bool fresh = false;
+		void *ptr = (is_large) ? NULL : cache_get(size);
+
+		if (!ptr) {
+			arena_lock(tcache);
+
+				cache_sync(tcache);
+				ptr = find_memory(tcache, size, &fresh);
+				if (ptr && !is_large) cache_fill(tcache, size);
+				if (ptr) {
+					if (!is_tiny) SET_MAGIC(ptr);
+					tcache->alloc_count++;
+					STATS_ADD(tcache->stats.allocs[STATS_CLASS((is_tiny) ? ALIGN(size) : GET_SIZE((t_chunk *)GET_HEAD(ptr)))], 1);
+				}
 
-		mutex(&tcache->mutex, MTX_LOCK);
+			mutex(&tcache->mutex, MTX_UNLOCK);
+		} else if (!is_tiny) SET_MAGIC(ptr);
 
-			bool is_large = ALIGN(size + sizeof(t_chunk)) > SMALL_CHUNK + sizeof(t_chunk);
+		// Memory that was never handed out is still zero from mmap (no need to touch its pages)
+		bool zero = ptr && !fresh && source == SRC_CALLOC;
 
-			ptr = find_memory(tcache, size);
+		if (ptr && (g_manager.options.PERTURB || zero)) {
+			size_t usable = (is_tiny) ? ALIGN(size) : GET_SIZE((t_chunk *)GET_HEAD(ptr));
+			if (zero) ft_memset(ptr, 0, (is_large) ? size : usable);
+			else if (source != SRC_CALLOC) ft_memset(ptr, g_manager.options.PERTURB ^ 0xFF, usable);
+		}
 
-			if (ptr && (g_manager.options.PERTURB || (!is_large && !ft_strcmp(source, "CALLOC")))) {
-				if (!is_large && !ft_strcmp(source, "CALLOC")) ft_memset(ptr, 0, GET_SIZE((t_chunk *)GET_HEAD(ptr)));
-				else if (ft_strcmp(source, "CALLOC")) ft_memset(ptr, g_manager.options.PERTURB ^ 0xFF, GET_SIZE((t_chunk *)GET_HEAD(ptr)));
-			}
+		if (ptr && print_log(0))	aprintf(g_manager.options.fd_out, 1, "%p\t [%s] Allocated %u bytes\n", ptr, trace_name(source), size);
+		if (!ptr && print_log(1))	aprintf(g_manager.options.fd_out, 1, "\t\t  [ERROR] Failed to allocated %u bytes\n", size);
+		if (ptr && g_manager.options.TRACING)	trace_event(TRACE_ALLOC, ptr, size, source);
+		if (ptr && g_manager.options.PROFILE && PROFILE_SAMPLED(size))	profile_alloc(ptr, size);
 
-			if (ptr && print_log(0))	aprintf(g_manager.options.fd_out, 1, "%p\t [%s] Allocated %u bytes\n", ptr, source, size);
-			if (!ptr && print_log(1))	aprintf(g_manager.options.fd_out, 1, "\t\t  [ERROR] Failed to allocated %u bytes\n", size);
+		if (!ptr) errno = ENOMEM;
+		return (ptr);
+	}
 
-			if (ptr) {
-				SET_MAGIC(ptr);
-				tcache->alloc_count++;
-			}
+	void *allocate(int source, size_t size) {
+		if (!g_manager.options.LATENCY || !latency_sample()) return (allocate_memory(source, size));
 
-		mutex(&tcache->mutex, MTX_UNLOCK);
+		uint64_t	start = latency_ticks();
+		void		*ptr = allocate_memory(source, size);
+		uint64_t	ticks = latency_ticks() - start;
 
-		if (!ptr) errno = ENOMEM;
+		latency_record(LAT_MALLOC, latency_type(ptr), ticks);
 		return (ptr);
 	}
 
@@ -12,33 +12,68 @@
 
 #pragma region "Includes"
 
+	#define _GNU_SOURCE
+
 	#include "arena.h"
 
+	#include <sched.h>
+
 #pragma endregion
 
 #pragma region "Initialize"
 
 	void arena_initialize(t_arena *arena) {
-		arena->id = g_manager.arena_count++;
+		arena->id = g_manager.arena_count;
 		arena->alloc_count = 0;
 		arena->free_count = 0;
-		ft_memset(arena->bins, 0, 257 * sizeof(void *));
+		arena->threads = 0;
+		arena->contention = 0;
+		ft_memset(arena->bins, 0, sizeof(arena->bins));
+		ft_memset(arena->binmap, 0, sizeof(arena->binmap));
+		ft_memset(arena->slabs, 0, sizeof(arena->slabs));
+		arena->remote_free = NULL;
 		arena->heap_header = NULL;
+		arena->heap_size[TINY] = TINY_SIZE;
+		arena->heap_size[SMALL] = SMALL_SIZE;
+		arena->heap_size[MEDIUM] = MEDIUM_SIZE;
+		arena->retained = 0;
+		ft_memset(&arena->stats, 0, sizeof(arena->stats));
 		arena->next = NULL;
 		mutex(&arena->mutex, MTX_INIT);
 	}
 
 #pragma endregion
 
+#pragma region "Lock"
+
+	void arena_lock(t_arena *arena) {
+		if (!mutex(&arena->mutex, MTX_TRYLOCK)) {
+			if (arena == tcache && thread_cache.contended) thread_cache.contended--;
+			return ;
+		}
+
+		// Contended (counted for the arena and for the thread bound to it)
+		__atomic_add_fetch(&arena->contention, 1, __ATOMIC_RELAXED);
+		if (arena == tcache) thread_cache.contended++;
+
+		mutex(&arena->mutex, MTX_LOCK);
+	}
+
+#pragma endregion
+
 #pragma region "Find"
 
 	t_arena *arena_find() {
+		if (tcache && thread_cache.contended >= ARENA_MIGRATE) arena_migrate();
 		if (!tcache) {
 			tcache = arena_get();
 			if (!tcache) {
 				if (print_log(1)) aprintf(g_manager.options.fd_out, 1, "\t\t  [ERROR] Failed to assign arena\n");
 				errno = ENOMEM; return (NULL);
 			}
+
+			// The destructor of the key runs when the thread exits
+			pthread_setspecific(g_manager.thread_key, tcache);
 		}
 
 		return (tcache);
@@ -88,7 +123,8 @@
 
 			t_arena *current = &g_manager.arena;
 			while (current->next) current = current->next;
-			current->next = new_arena;
+			__atomic_store_n(&current->next, new_arena, __ATOMIC_RELEASE);
+			__atomic_store_n(&g_manager.arena_count, new_arena->id + 1, __ATOMIC_RELEASE);
 
 			if (print_log(2)) aprintf(g_manager.options.fd_out, 1, "\t\t [SYSTEM] Arena #%d created\n", new_arena->id);
 
@@ -101,22 +137,54 @@
 
 #pragma region "Reuse"
 
-	t_arena *arena_reuse() {
-		t_arena *current, *best_arena = NULL;
+	#pragma region "Load"
+
+		static uint64_t arena_load(t_arena *arena) {
+			return ((uint64_t)__atomic_load_n(&arena->threads, __ATOMIC_RELAXED) * ARENA_LOAD + __atomic_load_n(&arena->contention, __ATOMIC_RELAXED));
+		}
+
+	#pragma endregion
 
-		current = &g_manager.arena;
-		while (current) {
-			if (!mutex(&current->mutex, MTX_TRYLOCK)) {
+	#pragma region "CPU"
+
+		static int arena_cpu() {
+			if (!g_manager.options.ARENA_CPU) return (-1);
+
+			#ifdef __linux__
+				int cpu = sched_getcpu();
+				if (cpu >= 0) return (cpu % __atomic_load_n(&g_manager.arena_count, __ATOMIC_ACQUIRE));
+			#endif
+
+			return (-1);
+		}
+
+	#pragma endregion
+
+	#pragma region "Reuse"
+
+		t_arena *arena_reuse(t_arena *exclude) {
+			t_arena		*current = &g_manager.arena, *best_arena = NULL;
+			uint64_t	best_load = UINT64_MAX;
+			int			cpu = arena_cpu();
+
+			// Least loaded arena (bound threads and recent contention), the one of this CPU on a tie
+			while (current) {
+				uint64_t load = arena_load(current);
+				if (current != exclude && (load < best_load || (load == best_load && current->id == cpu))) {
 					best_arena = current;
-				mutex(&current->mutex, MTX_UNLOCK);
-				// return (NULL);	// Force arena creation
-				break;
+					best_load = load;
+				}
+				current = current->next;
 			}
-			current = current->next;
+
+			// Contention is only relevant if recent
+			for (current = &g_manager.arena; current; current = current->next)
+				__atomic_store_n(&current->contention, __atomic_load_n(&current->contention, __ATOMIC_RELAXED) / 2, __ATOMIC_RELAXED);
+
+			return (best_arena);
 		}
 
-		return (best_arena);
-	}
+	#pragma endregion
 
 #pragma endregion
 
@@ -130,13 +198,20 @@
 
 			if (!initialized) {
 				initialized = true;
+				pthread_key_create(&g_manager.thread_key, arena_release);
 				arena_initialize(&g_manager.arena);
+				__atomic_store_n(&g_manager.arena_count, 1, __ATOMIC_RELEASE);
 				arena = &g_manager.arena;
 				if (print_log(2))	aprintf(g_manager.options.fd_out, 1, "\t\t [SYSTEM] Arena #%d created\n", arena->id);
 			}
-			if (!arena) arena = arena_reuse();
-			if (!arena) arena = arena_create();
+			// An arena without threads is reused, otherwise a new one is created (up to the limit)
+			if (!arena) arena = arena_reuse(NULL);
+			if (!arena || arena->threads) {
+				t_arena *new_arena = arena_create();
+				if (new_arena) arena = new_arena;
+			}
 			if (!arena) arena = &g_manager.arena;
+			__atomic_add_fetch(&arena->threads, 1, __ATOMIC_RELAXED);
 
 			if (print_log(2))		aprintf(g_manager.options.fd_out, 1, "\t\t [SYSTEM] Arena #%d assigned\n", arena->id);
 
@@ -146,3 +221,70 @@
 	}
 
 #pragma endregion
+
+#pragma region "Migrate"
+
+	void arena_migrate() {
+		t_arena *arena = tcache;
+
+		thread_cache.contended = 0;
+		if (!arena || __atomic_load_n(&arena->threads, __ATOMIC_RELAXED) < 2) return ;
+
+		mutex(&g_manager.mutex, MTX_LOCK);
+
+			// Only worth it if the other arena is less loaded (counting this thread out of the current one)
+			uint64_t	load = arena_load(arena) - ARENA_LOAD;
+			t_arena		*new_arena = arena_reuse(arena);
+			if (new_arena && new_arena->threads) {
+				t_arena *created = arena_create();
+				if (created) new_arena = created;
+			}
+
+			if (new_arena && arena_load(new_arena) < load) {
+				// Counters of this thread belong to the arena they were made in
+				mutex(&arena->mutex, MTX_LOCK);
+
+					cache_sync(arena);
+
+				mutex(&arena->mutex, MTX_UNLOCK);
+
+				__atomic_sub_fetch(&arena->threads, 1, __ATOMIC_RELAXED);
+				__atomic_add_fetch(&new_arena->threads, 1, __ATOMIC_RELAXED);
+				tcache = new_arena;
+				if (print_log(2)) aprintf(g_manager.options.fd_out, 1, "\t\t [SYSTEM] Thread migrated from arena #%d to arena #%d\n", arena->id, new_arena->id);
+			}
+
+		mutex(&g_manager.mutex, MTX_UNLOCK);
+	}
+
+#pragma endregion
+
+#pragma region "Release"
+
+	void arena_release(void *value) {
+		t_arena *arena = tcache;
+
+		(void)value;
+		if (!arena) return ;
+
+		// Cached chunks go back to their heaps (the thread will not reuse them)
+		cache_flush();
+
+		mutex(&arena->mutex, MTX_LOCK);
+
+			cache_sync(arena);
+			remote_drain(arena);
+
+		mutex(&arena->mutex, MTX_UNLOCK);
+
+		// An arena without threads is the first choice for the next thread
+		__atomic_sub_fetch(&arena->threads, 1, __ATOMIC_RELAXED);
+		tcache = NULL;
+		thread_cache.contended = 0;
+		latency_release();
+		trace_release();
+
+		if (print_log(2)) aprintf(g_manager.options.fd_out, 1, "\t\t [SYSTEM] Arena #%d released\n", arena->id);
+	}
+
+#pragma endregion
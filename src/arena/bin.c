@@ -78,6 +78,20 @@
 
 #pragma endregion
 
+#pragma region "Bin Index"
+
+	static int bin_index(size_t size) {
+		if (size <= SMALL_CHUNK + sizeof(t_chunk)) return ((size / ALIGNMENT) - 1);
+
+		// 4 bins per power of two (sizes above 2048 start at 2^11)
+		int log2 = 63 - __builtin_clzll(size);
+		int index = SMALL_BINS + ((log2 - 11) * 4) + ((size >> (log2 - 2)) & 3);
+
+		return ((index < BINS) ? index : BINS - 1);
+	}
+
+#pragma endregion
+
 #pragma region "Link Chunk"
 
 	int link_chunk(t_chunk *chunk, t_arena *arena, t_heap *heap) {
@@ -85,20 +99,31 @@
 		
 		heap->free_chunks++;
 		
-		int index = ((GET_SIZE(chunk) + sizeof(t_chunk)) / ALIGNMENT) - 1;
-		if ((size_t)index >= (SMALL_CHUNK + sizeof(t_chunk)) / ALIGNMENT) return (1);
+		int index = bin_index(GET_SIZE(chunk) + sizeof(t_chunk));
 		
-		SET_FD(chunk, arena->bins[index]);
-		arena->bins[index] = chunk;
-
 		if (g_manager.options.PERTURB) {
-			void *fd_backup = GET_FD(chunk);
 			uint32_t prev_size_backup = GET_PREV_SIZE(GET_NEXT(chunk));
 			ft_memset(GET_PTR(chunk), g_manager.options.PERTURB, GET_SIZE(chunk));
-			SET_FD(chunk, fd_backup);
 			SET_PREV_SIZE(GET_NEXT(chunk), prev_size_backup);
 		}
 
+		// Range bins are kept sorted by size, so the first chunk that fits is the best fit
+		t_chunk *prev = NULL;
+		t_chunk *next = (t_chunk *)arena->bins[index];
+		if (index >= SMALL_BINS) {
+			while (next && GET_SIZE(next) < GET_SIZE(chunk)) {
+				prev = next;
+				next = (t_chunk *)GET_FD(next);
+			}
+		}
+
+		SET_FD(chunk, next);
+		SET_BK(chunk, prev);
+		if (next) SET_BK(next, chunk);
+		if (prev) SET_FD(prev, chunk);
+		else arena->bins[index] = chunk;
+		arena->binmap[index / 64] |= (uint64_t)1 << (index % 64);
+
 		if (print_log(2))	aprintf(g_manager.options.fd_out, 1, "%p\t [SYSTEM] Chunk added to Bin\n", chunk);
 
 		return (0);
@@ -113,23 +138,27 @@
 
 		if (heap->free_chunks > 0) heap->free_chunks--;
 
-		int index = ((GET_SIZE(chunk) + sizeof(t_chunk)) / ALIGNMENT) - 1;
-		if ((size_t)index >= (SMALL_CHUNK + sizeof(t_chunk)) / ALIGNMENT) return (1);
+		int index = bin_index(GET_SIZE(chunk) + sizeof(t_chunk));
 
-		t_chunk **current = (t_chunk **)&arena->bins[index];
-		
-		while (*current) {
-			if (*current == chunk) {
-				*current = (t_chunk *)GET_FD(chunk);
-				SET_FD(chunk, NULL);
-				
-				if (print_log(2))	aprintf(g_manager.options.fd_out, 1, "%p\t [SYSTEM] Chunk removed from Bin\n", chunk);
-				return (0);
-			}
-			current = (t_chunk **)((char *)*current + sizeof(t_chunk));
-		}
+		t_chunk *fd = (t_chunk *)GET_FD(chunk);
+		t_chunk *bk = (t_chunk *)GET_BK(chunk);
+
+		// Not in the bin
+		if (bk) { if (GET_FD(bk) != chunk) return (1); }
+		else if (arena->bins[index] != chunk) return (1);
+		if (fd && GET_BK(fd) != chunk) return (1);
+
+		if (bk)	SET_FD(bk, fd);
+		else	arena->bins[index] = fd;
+		if (fd)	SET_BK(fd, bk);
+		if (!arena->bins[index]) arena->binmap[index / 64] &= ~((uint64_t)1 << (index % 64));
 
-		return (1);
+		SET_FD(chunk, NULL);
+		SET_BK(chunk, NULL);
+
+		if (print_log(2))	aprintf(g_manager.options.fd_out, 1, "%p\t [SYSTEM] Chunk removed from Bin\n", chunk);
+
+		return (0);
 	}
 
 #pragma endregion
@@ -151,9 +180,10 @@
 			SET_POISON(GET_PTR(chunk));
 
 			top_chunk = GET_NEXT(chunk);
-			top_chunk->size = (top_chunk_available - size) | TOP_CHUNK | ((heap->type == SMALL) ? HEAP_TYPE : 0) | PREV_INUSE;
+			top_chunk->size = (top_chunk_available - size) | TOP_CHUNK | ((heap->type != LARGE) ? HEAP_TYPE : 0) | PREV_INUSE;
 			heap->top_chunk = top_chunk;
 			SET_MAGIC(GET_PTR(top_chunk));
+			if ((void *)top_chunk > heap->untouched) heap->untouched = top_chunk;
 
 			return (chunk);
 		}
@@ -163,13 +193,13 @@
 	#pragma region "New Chunk"
 
 		void *get_bestheap(t_arena *arena, int type, size_t size) {
-			if (!arena || !size || type < TINY || type > SMALL) return (NULL);
+			if (!arena || !size || type < TINY || type > MEDIUM) return (NULL);
 
 			t_heap	*best_heap = NULL;
 			float	best_usage = -1000;
 
 			// Find first heap
-			size_t			heap_size = (type == TINY) ? TINY_SIZE : SMALL_SIZE;
+			size_t			heap_size = (type == TINY) ? TINY_SIZE : (type == SMALL) ? SMALL_SIZE : MEDIUM_SIZE;
 			t_heap_header	*heap_header = arena->heap_header;
 			t_heap			*heap = NULL;
 
@@ -219,16 +249,40 @@
 
 #pragma endregion
 
+#pragma region "Next Bin"
+
+	static int next_bin(t_arena *arena, int index) {
+		if (index < 0 || index >= BINS) return (-1);
+
+		int			word = index / 64;
+		uint64_t	bits = arena->binmap[word] & (~(uint64_t)0 << (index % 64));
+
+		while (!bits) {
+			if (++word >= BINMAP_WORDS) return (-1);
+			bits = arena->binmap[word];
+		}
+
+		index = (word * 64) + __builtin_ctzll(bits);
+		return ((index < BINS) ? index : -1);
+	}
+
+#pragma endregion
+
 #pragma region "Find in Bin"
 
 	void *find_in_bin(t_arena *arena, size_t size) {
 		if (!arena || !size) return (NULL);
 
-		int index = (size / ALIGNMENT) - 1;
-		while (!arena->bins[index] && (size_t)index < (SMALL_CHUNK + sizeof(t_chunk)) / ALIGNMENT) index++;
+		int		index = next_bin(arena, bin_index(size));
+		t_chunk	*chunk = (index >= 0) ? (t_chunk *)arena->bins[index] : NULL;
 
-		if (arena->bins[index] && (size_t)index < (SMALL_CHUNK + sizeof(t_chunk)) / ALIGNMENT) {
-			t_chunk *chunk = (t_chunk *)arena->bins[index];
+		// Range bins can hold smaller chunks than the request (first fit of a sorted bin)
+		if (index >= SMALL_BINS) {
+			while (chunk && GET_SIZE(chunk) + sizeof(t_chunk) < size) chunk = (t_chunk *)GET_FD(chunk);
+			if (!chunk && (index = next_bin(arena, index + 1)) >= 0) chunk = (t_chunk *)arena->bins[index];
+		}
+
+		if (chunk) {
 
 			if (!HAS_POISON(GET_PTR(chunk))) {
 				if (print_log(1))		aprintf(g_manager.options.fd_out, 1, "%p\t  [ERROR] Corrupted chunk in bin\n", GET_PTR(chunk));
@@ -236,11 +290,15 @@
 				abort_now(); return (NULL);
 			}
 
-			bool reduce_chunk = false;
-			size_t min_size = (size > TINY_CHUNK + sizeof(t_chunk)) ? TINY_CHUNK + sizeof(t_chunk) : ALIGNMENT + sizeof(t_chunk);
-			if (GET_SIZE(chunk) + sizeof(t_chunk) >= size + min_size) {
-				arena->bins[index] = GET_FD(chunk);
+			t_heap *heap = heap_find(arena, GET_PTR(chunk));
+			if (!heap || !heap->active || unlink_chunk(chunk, arena, heap)) {
+				if (print_log(1))		aprintf(g_manager.options.fd_out, 1, "%p\t  [ERROR] Corrupted chunk in bin\n", GET_PTR(chunk));
+				if (print_error())		aprintf(2, 0, "Memory corrupted\n");
+				abort_now(); return (NULL);
+			}
 
+			size_t min_size = (size > TINY_CHUNK + sizeof(t_chunk)) ? TINY_CHUNK + sizeof(t_chunk) : MIN_CHUNK;
+			if (GET_SIZE(chunk) + sizeof(t_chunk) >= size + min_size) {
 				size_t original_chunk_size = GET_SIZE(chunk);
 				size_t original_flags = chunk->size & (HEAP_TYPE | PREV_INUSE);
 				size_t new_chunk_size = (original_chunk_size + sizeof(t_chunk)) - size;
@@ -256,25 +314,14 @@
 				SET_PREV_SIZE(next_chunk, GET_SIZE(new_chunk));
 				next_chunk->size &= ~PREV_INUSE;
 
-				int new_index = ((GET_SIZE(new_chunk) + sizeof(t_chunk)) / ALIGNMENT) - 1;
-				if ((size_t)new_index < (SMALL_CHUNK + sizeof(t_chunk)) / ALIGNMENT) {
-					SET_FD(new_chunk, arena->bins[new_index]);
-					arena->bins[new_index] = new_chunk;
-				}
+				link_chunk(new_chunk, arena, heap);
 			} else {
-				arena->bins[index] = GET_FD(chunk);
-				SET_FD(chunk, NULL);
 				t_chunk *next = GET_NEXT(chunk);
 				next->size |= PREV_INUSE;
-				reduce_chunk = true;
-			}
-			
-			t_heap *heap = heap_find(arena, GET_PTR(chunk));
-			if (heap && heap->active) {
-				heap->free -= (GET_SIZE(chunk) + sizeof(t_chunk));
-				if (heap->free_chunks > 0) heap->free_chunks -= reduce_chunk;
 			}
 
+			heap->free -= (GET_SIZE(chunk) + sizeof(t_chunk));
+
 			if (print_log(2)) aprintf(g_manager.options.fd_out, 1, "%p\t [SYSTEM] Bin match for size %u bytes\n", GET_PTR(chunk), size);
 
 			return (GET_PTR(chunk));
@@ -287,33 +334,55 @@
 
 #pragma region "Find Memory"
 
-	void *find_memory(t_arena *arena, size_t size) {
+	void *find_memory(t_arena *arena, size_t size, bool *fresh) {
+		if (fresh) *fresh = false;
 		if (!arena || !size) return (NULL);
 
-		if (ALIGN(size + sizeof(t_chunk)) > SMALL_CHUNK) return (heap_create(arena, LARGE, size, 0));
-
 		void *ptr = NULL;
 
-		size = ALIGN(size + sizeof(t_chunk));
+		if (size > __atomic_load_n(&g_manager.mmap_threshold, __ATOMIC_RELAXED)) {
+			ptr = heap_create(arena, LARGE, size, 0);
+			if (ptr && fresh) *fresh = !pagemap_get(ptr)->dirty;
+			if (ptr) STATS_ADD(arena->stats.in_use, GET_SIZE((t_chunk *)GET_HEAD(ptr)));
+			return (ptr);
+		}
+
+		remote_drain(arena);
+
+		if (size <= TINY_CHUNK) {
+			thread_cache.path = (arena->slabs[SLAB_CLASS(size)]) ? LAT_BIN : LAT_TOP;
+			return (slab_alloc(arena, size));
+		}
+
+		size = CHUNK_SIZE(size);
 		ptr = find_in_bin(arena, size);
+		thread_cache.path = LAT_BIN;
 
 		if (!ptr) {
-			int type = (size > TINY_CHUNK) ? SMALL : TINY;
-			t_heap *heap = get_bestheap(arena, type, size);
+			int		type = (size > SMALL_CHUNK + sizeof(t_chunk)) ? MEDIUM : SMALL;
+			thread_cache.path = LAT_TOP;
+			t_heap	*heap = get_bestheap(arena, type, size);
 			if (heap) {
+				void	*untouched = heap->untouched;
 				t_chunk	*chunk = split_top_chunk(heap, size);
 				if (!chunk) {
-					heap = (t_heap *)heap_create(arena, type, (type == TINY) ? TINY_SIZE : SMALL_SIZE, 0);
+					heap = (t_heap *)heap_create(arena, type, (type == SMALL) ? SMALL_SIZE : MEDIUM_SIZE, 0);
 					if (!heap) return (ptr);
+					untouched = heap->untouched;
 					chunk = split_top_chunk(heap, size);
 					if (!chunk) return (ptr);
 				}
 
 				heap->free -= size;
 				ptr = (GET_PTR(chunk));
+
+				// Memory after the high-water mark was never handed out, so it is still zero from mmap
+				if (fresh) *fresh = ptr >= untouched;
 			}
 		}
 
+		if (ptr) STATS_ADD(arena->stats.in_use, GET_SIZE((t_chunk *)GET_HEAD(ptr)));
+
 		return (ptr);
 	}
 
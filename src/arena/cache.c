@@ -0,0 +1,324 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   cache.c                                            :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vzurera- <vzurera-@student.42malaga.com    +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 10:12:44 by vzurera-          #+#    #+#             */
+/*   Updated: 2026/10/17 10:12:44 by vzurera-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#pragma region "Includes"
+
+	#include "arena.h"
+
+#pragma endregion
+
+#pragma region "Enabled"
+
+	static bool cache_enabled() {
+		return (!g_manager.options.DEBUG && !g_manager.options.LOGGING);
+	}
+
+#pragma endregion
+
+#pragma region "Index"
+
+	static int cache_index(size_t size) {
+		if (size <= TINY_CHUNK) return (CACHE_BINS + SLAB_CLASS(size));
+
+		size_t index = (CHUNK_SIZE(size) / ALIGNMENT) - 1;
+		return ((index < CACHE_BINS) ? (int)index : -1);
+	}
+
+#pragma endregion
+
+#pragma region "Usable"
+
+	static size_t cache_usable(void *ptr, int index) {
+		if (index < (int)CACHE_BINS) return (GET_SIZE((t_chunk *)GET_HEAD(ptr)));
+
+		return ((index - CACHE_BINS + 1) * ALIGNMENT);
+	}
+
+	static inline void cache_count(int *counts, size_t size, int value) {
+		int i = STATS_CLASS(size);
+
+		counts[i] += value;
+		thread_cache.classes |= (uint64_t)1 << i;
+	}
+
+#pragma endregion
+
+#pragma region "Pop"
+
+	static void *cache_pop(int index) {
+		void *ptr = thread_cache.bins[index];
+
+		if (index < (int)CACHE_BINS) {
+			thread_cache.bins[index] = GET_FD(ptr);
+			ptr = GET_PTR(ptr);
+		} else {
+			thread_cache.bins[index] = *(void **)ptr;
+			CLEAR_SLAB_CACHED(ptr);
+		}
+		thread_cache.counts[index]--;
+
+		return (ptr);
+	}
+
+#pragma endregion
+
+#pragma region "Spill"
+
+	static void cache_spill(int index) {
+		void	*ptrs[CACHE_COUNT];
+		int		count = thread_cache.counts[index] / 2, n = 0;
+
+		while (n < count && thread_cache.bins[index]) {
+			void *ptr = cache_pop(index);
+
+			if (index < (int)CACHE_BINS) SET_MAGIC(ptr);
+			cache_count(thread_cache.frees, cache_usable(ptr, index), -1);
+			thread_cache.free_count--;
+			ptrs[n++] = ptr;
+		}
+
+		// One lock per arena instead of one per chunk
+		thread_cache.path = LAT_BIN;
+		release_batch(ptrs, n);
+	}
+
+#pragma endregion
+
+#pragma region "Flush"
+
+	void cache_flush() {
+		void	*ptrs[CACHE_COUNT];
+		int		n = 0;
+
+		for (int index = 0; index < (int)(CACHE_BINS + SLAB_CLASSES); ++index) {
+			while (thread_cache.bins[index]) {
+				void *ptr = cache_pop(index);
+
+				if (index < (int)CACHE_BINS) SET_MAGIC(ptr);
+				cache_count(thread_cache.frees, cache_usable(ptr, index), -1);
+				thread_cache.free_count--;
+				ptrs[n++] = ptr;
+
+				if (n == CACHE_COUNT) { release_batch(ptrs, n); n = 0; }
+			}
+		}
+
+		release_batch(ptrs, n);
+	}
+
+#pragma endregion
+
+#pragma region "Fill"
+
+	void cache_fill(t_arena *arena, size_t size) {
+		if (!arena || !cache_enabled()) return ;
+
+		int index = cache_index(size);
+		if (index < 0) return ;
+
+		// Slab objects
+		if (index >= (int)CACHE_BINS) {
+			while (thread_cache.counts[index] < CACHE_FILL && arena->slabs[SLAB_CLASS(size)]) {
+				void *ptr = slab_alloc(arena, size);
+				if (!ptr) break;
+
+				SET_SLAB_CACHED(ptr);
+				*(void **)ptr = thread_cache.bins[index];
+				thread_cache.bins[index] = ptr;
+				thread_cache.counts[index]++;
+			}
+			return ;
+		}
+
+		size = CHUNK_SIZE(size);
+		while (thread_cache.counts[index] < CACHE_FILL && arena->bins[index]) {
+			t_chunk *chunk = (t_chunk *)arena->bins[index];
+			if (!HAS_POISON(GET_PTR(chunk))) break;
+
+			t_heap *heap = heap_find(arena, GET_PTR(chunk));
+			if (!heap || !heap->active || unlink_chunk(chunk, arena, heap)) break;
+
+			t_chunk *next_chunk = GET_NEXT(chunk);
+			next_chunk->size |= PREV_INUSE;
+			heap->free -= size;
+			STATS_ADD(arena->stats.in_use, GET_SIZE(chunk));
+
+			SET_FD(chunk, thread_cache.bins[index]);
+			thread_cache.bins[index] = chunk;
+			thread_cache.counts[index]++;
+		}
+	}
+
+#pragma endregion
+
+#pragma region "Sync"
+
+	void cache_sync(t_arena *arena) {
+		if (!arena) return ;
+
+		if (!thread_cache.alloc_count && !thread_cache.free_count) return ;
+
+		arena->alloc_count += thread_cache.alloc_count;
+		arena->free_count += thread_cache.free_count;
+		thread_cache.alloc_count = 0;
+		thread_cache.free_count = 0;
+
+		// Only the size classes used since the last sync
+		for (uint64_t classes = thread_cache.classes; classes; classes &= classes - 1) {
+			int i = __builtin_ctzll(classes);
+			STATS_ADD(arena->stats.allocs[i], (size_t)thread_cache.allocs[i]);
+			STATS_ADD(arena->stats.frees[i], (size_t)thread_cache.frees[i]);
+			thread_cache.allocs[i] = 0;
+			thread_cache.frees[i] = 0;
+		}
+		thread_cache.classes = 0;
+	}
+
+#pragma endregion
+
+#pragma region "Get"
+
+	void *cache_get(size_t size) {
+		if (!cache_enabled()) return (NULL);
+
+		int index = cache_index(size);
+		if (index < 0 || !thread_cache.bins[index]) return (NULL);
+
+		void *ptr = (index < (int)CACHE_BINS) ? GET_PTR(thread_cache.bins[index]) : thread_cache.bins[index];
+		if ((index < (int)CACHE_BINS) ? !HAS_POISON(ptr) : !SLAB_CACHED(ptr)) {
+			if (print_log(1))		aprintf(g_manager.options.fd_out, 1, "%p\t  [ERROR] Corrupted chunk in cache\n", ptr);
+			if (print_error())		aprintf(2, 0, "Memory corrupted\n");
+			thread_cache.bins[index] = NULL;
+			thread_cache.counts[index] = 0;
+			abort_now(); return (NULL);
+		}
+
+		ptr = cache_pop(index);
+		thread_cache.alloc_count++;
+		cache_count(thread_cache.allocs, cache_usable(ptr, index), 1);
+
+		return (ptr);
+	}
+
+#pragma endregion
+
+#pragma region "Put"
+
+	#pragma region "Slab"
+
+		static int cache_put_slab(void *ptr, t_heap *heap, size_t size) {
+			if (slab_check(ptr, heap)) return (1);
+
+			// free_sized() (the slab has to agree with the size)
+			t_slab *slab = GET_SLAB(ptr);
+			if (size && (size > TINY_CHUNK || slab->size != ALIGN(size))) return (1);
+			int index = CACHE_BINS + SLAB_CLASS(slab->size);
+
+			// Double free
+			if (SLAB_CACHED(ptr)) {
+				if (print_log(1))		aprintf(g_manager.options.fd_out, 1, "%p\t  [ERROR] Double free (free: cached)\n", ptr);
+				if (print_error())		aprintf(2, 0, "free: Double free\n");
+				abort_now(); return (0);
+			}
+
+			if (thread_cache.counts[index] >= CACHE_COUNT) cache_spill(index);
+
+			if (g_manager.options.PERTURB) ft_memset(ptr, g_manager.options.PERTURB, slab->size);
+			SET_SLAB_CACHED(ptr);
+
+			*(void **)ptr = thread_cache.bins[index];
+			thread_cache.bins[index] = ptr;
+			thread_cache.counts[index]++;
+			thread_cache.free_count++;
+			cache_count(thread_cache.frees, slab->size, 1);
+
+			return (0);
+		}
+
+	#pragma endregion
+
+	#pragma region "Chunk"
+
+		static int cache_put_chunk(void *ptr, size_t size) {
+			if (!HAS_MAGIC(ptr)) return (1);
+
+			t_chunk *chunk = (t_chunk *)GET_HEAD(ptr);
+			if (chunk->size & (TOP_CHUNK | MMAP_CHUNK)) return (1);
+
+			// free_sized() (the chunk has to agree with the size)
+			if (size && GET_SIZE(chunk) + sizeof(t_chunk) != CHUNK_SIZE(size)) return (1);
+
+			int index = ((GET_SIZE(chunk) + sizeof(t_chunk)) / ALIGNMENT) - 1;
+			if ((size_t)index >= CACHE_BINS) return (1);
+			t_chunk *next_chunk = GET_NEXT(chunk);
+			if (!(next_chunk->size & PREV_INUSE)) return (1);
+
+			if (thread_cache.counts[index] >= CACHE_COUNT) cache_spill(index);
+
+			SET_POISON(ptr);
+			if (g_manager.options.PERTURB) ft_memset(ptr, g_manager.options.PERTURB, GET_SIZE(chunk));
+
+			SET_FD(chunk, thread_cache.bins[index]);
+			thread_cache.bins[index] = chunk;
+			thread_cache.counts[index]++;
+			thread_cache.free_count++;
+			cache_count(thread_cache.frees, GET_SIZE(chunk), 1);
+
+			return (0);
+		}
+
+	#pragma endregion
+
+	int cache_put(void *ptr) {
+		if (!ptr || !cache_enabled()) return (1);
+
+		t_heap *heap = pagemap_get(ptr);
+		if (!heap || !heap->active || heap->type == LARGE) return (1);
+		if (heap->type == TINY) return (cache_put_slab(ptr, heap, 0));
+
+		return (cache_put_chunk(ptr, 0));
+	}
+
+	#pragma region "Sized"
+
+		int cache_put_sized(void *ptr, size_t size) {
+			if (!ptr || !size || !cache_enabled()) return (1);
+
+			t_heap *heap = pagemap_get(ptr);
+			if (!heap || !heap->active) return (1);
+
+			// Same checks as free(), the size only has to agree with the slab or chunk
+			if (heap->type == TINY)		return (cache_put_slab(ptr, heap, size));
+			if (heap->type == SMALL)	return (cache_put_chunk(ptr, size));
+
+			return (1);
+		}
+
+	#pragma endregion
+
+#pragma endregion
+
+#pragma region "Information"
+
+	// Per-thread cache of freed SMALL chunks (bucketed by chunk size) and TINY slab objects (bucketed by size class).
+	//
+	//   • free() stores the chunk here without taking any lock (POISON is set, but the chunk stays in use for its heap).
+	//   • malloc() reuses an exact size match from here before locking the arena.
+	//   • On a miss, up to CACHE_FILL chunks of the same size are moved from the arena bin to the cache.
+	//   • When a cache bin is full, half of it is returned to its arena (with release_batch(), one lock per arena).
+	//   • free_sized() makes the same checks as free(), and the slab or chunk also has to agree with the size it is given.
+	//
+	// Notes:
+	//   • Slab objects are linked through their first word and marked in the cached bitmap of their slab (cleared when they leave the cache).
+	//   • Disabled in debug and logging modes, so every allocation and free is reported as it happens.
+
+#pragma endregion
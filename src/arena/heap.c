@@ -12,6 +12,8 @@
 
 #pragma region "Includes"
 
+	#define _GNU_SOURCE
+
 	#include "arena.h"
 
 #pragma endregion
@@ -45,59 +47,246 @@
 #pragma region "Find"
 
 	t_heap *heap_find(t_arena *arena, void *ptr) {
-		if (!arena || !ptr || !arena->heap_header) return (NULL);
+		if (!arena || !ptr) return (NULL);
 
-		t_heap *found = NULL;
-		t_heap_header *heap_header = arena->heap_header;
-		while (heap_header) {
-			t_heap *heap = (t_heap *)((char *)heap_header + ALIGN(sizeof(t_heap_header)));
+		t_heap *heap = pagemap_get(ptr);
+		if (!heap || heap->arena != arena) return (NULL);
 
-			for (int i = 0; i < heap_header->used; ++i) {
-				if (ptr >= (void *)((char *)heap->ptr - heap->padding) && ptr < (void *)((char *)heap->ptr + heap->size)) {
-					if (heap->active) return (heap);
-					found = heap;
+		return (heap);
+	}
+
+#pragma endregion
+
+#pragma region "Unmap"
+
+	static int heap_unmap(t_heap *heap) {
+		if (heap->superblock) return (superblock_release(heap->arena, heap->superblock, heap->ptr - heap->padding, heap->size + heap->padding));
+
+		if (munmap(heap->ptr - heap->padding, heap->size + heap->padding)) return (1);
+		STATS_SUB(heap->arena->stats.mapped, heap->size + heap->padding);
+
+		return (0);
+	}
+
+#pragma endregion
+
+#pragma region "Retain"
+
+	#pragma region "Time"
+
+		static uint64_t heap_time() {
+			struct timespec ts;
+
+			if (clock_gettime(CLOCK_MONOTONIC, &ts)) return (0);
+
+			return (((uint64_t)ts.tv_sec * 1000) + (ts.tv_nsec / 1000000));
+		}
+
+	#pragma endregion
+
+	#pragma region "Purge"
+
+		static void heap_purge(t_arena *arena) {
+			if (!arena || !arena->retained) return ;
+
+			uint64_t		now = heap_time();
+			t_heap_header	*heap_header = arena->heap_header;
+
+			while (heap_header && arena->retained) {
+				t_heap *heap = (t_heap *)((char *)heap_header + ALIGN(sizeof(t_heap_header)));
+
+				for (int i = 0; i < heap_header->used; ++i) {
+					if (heap->retained && now - heap->retained_at >= (uint64_t)g_manager.options.RETAIN_DECAY) {
+						heap->retained = false;
+						STATS_SUB(arena->retained, heap->size + heap->padding);
+						if (heap_unmap(heap) && print_log(1))
+							aprintf(g_manager.options.fd_out, 1, "%p\t  [ERROR] Failed to unmap retained heap of size %d bytes\n", heap->ptr, heap->size);
+						else if (print_log(2))
+							aprintf(g_manager.options.fd_out, 1, "%p\t [SYSTEM] Retained heap of size %d bytes unmapped\n", heap->ptr, heap->size);
+					}
+					heap = (t_heap *)((char *)heap + ALIGN(sizeof(t_heap)));
 				}
-				heap = (t_heap *)((char *)heap + ALIGN(sizeof(t_heap)));
+
+				heap_header = heap_header->next;
 			}
+		}
 
-			heap_header = heap_header->next;
+	#pragma endregion
+
+	#pragma region "Reuse"
+
+		static t_heap *heap_reuse(t_arena *arena, int type, size_t size) {
+			heap_purge(arena);
+			if (!arena->retained) return (NULL);
+
+			t_heap_header *heap_header = arena->heap_header;
+			while (heap_header) {
+				t_heap *heap = (t_heap *)((char *)heap_header + ALIGN(sizeof(t_heap_header)));
+
+				for (int i = 0; i < heap_header->used; ++i) {
+					size_t total = heap->size + heap->padding;
+					if (heap->retained && heap->type == type && (type != LARGE || (total >= size && total <= size * 2))) {
+						heap->retained = false;
+						STATS_SUB(arena->retained, total);
+
+						if (print_log(2)) aprintf(g_manager.options.fd_out, 1, "%p\t [SYSTEM] Retained heap of size %d bytes reused\n", heap->ptr, heap->size);
+
+						return (heap);
+					}
+					heap = (t_heap *)((char *)heap + ALIGN(sizeof(t_heap)));
+				}
+
+				heap_header = heap_header->next;
+			}
+
+			return (NULL);
+		}
+
+	#pragma endregion
+
+	#pragma region "Retain"
+
+		static int heap_retain(t_heap *heap) {
+			t_arena	*arena = heap->arena;
+			size_t	total = heap->size + heap->padding;
+
+			heap_purge(arena);
+			if (!arena || !g_manager.options.RETAIN_DECAY) return (1);
+			if (arena->retained + total > (size_t)g_manager.options.RETAIN_MAX * 1024 * 1024) return (1);
+
+			heap->retained = true;
+			heap->retained_at = heap_time();
+			STATS_ADD(arena->retained, total);
+
+			return (0);
 		}
 
-		return (found);
+	#pragma endregion
+
+#pragma endregion
+
+#pragma region "Map"
+
+	void *heap_map(size_t *size, bool align) {
+		bool huge = g_manager.options.HUGE_PAGES && *size >= HUGE_PAGE_SIZE;
+
+		// Explicit huge pages (only works if there are pages reserved in hugetlbfs)
+		#ifdef MAP_HUGETLB
+			if (huge && g_manager.options.HUGE_PAGES == 2) {
+				size_t huge_size = (*size + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+				void *ptr = mmap(NULL, huge_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON | MAP_HUGETLB, -1, 0);
+				if (ptr != MAP_FAILED) { *size = huge_size; return (ptr); }
+				if (print_log(2)) aprintf(g_manager.options.fd_out, 1, "\t\t [SYSTEM] No huge pages reserved, using transparent huge pages\n");
+			}
+		#endif
+
+		// Aligned to a huge page boundary (so the kernel can back it with transparent huge pages)
+		if (huge || align) {
+			void *ptr = mmap(NULL, *size + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+			if (ptr == MAP_FAILED) return (ptr);
+
+			char	*aligned = (char *)(((uintptr_t)ptr + HUGE_PAGE_SIZE - 1) & ~(uintptr_t)(HUGE_PAGE_SIZE - 1));
+			size_t	head = aligned - (char *)ptr;
+
+			if (head) munmap(ptr, head);
+			if (HUGE_PAGE_SIZE - head) munmap(aligned + *size, HUGE_PAGE_SIZE - head);
+			#ifdef MADV_HUGEPAGE
+				if (huge) madvise(aligned, *size, MADV_HUGEPAGE);
+			#endif
+
+			return (aligned);
+		}
+
+		return (mmap(NULL, *size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0));
 	}
 
 #pragma endregion
 
 #pragma region "Create"
 
+	static uint8_t heap_header_total(size_t space) {
+		size_t total = (space - ALIGN(sizeof(t_heap_header))) / ALIGN(sizeof(t_heap));
+		return ((total > 255) ? 255 : total);
+	}
+
+	static size_t heap_next_size(t_arena *arena, int type) {
+		size_t size = arena->heap_size[type];
+		size_t max = (size_t)g_manager.options.HEAP_MAX * 1024 * 1024;
+
+		// TINY/SMALL heaps have to fit in a superblock (its first page is the header)
+		if (type != MEDIUM && max > SUPERBLOCK_SIZE - PAGE_SIZE) max = SUPERBLOCK_SIZE - PAGE_SIZE;
+
+		if (size < max) {
+			size_t next = size * g_manager.options.HEAP_GROWTH;
+			arena->heap_size[type] = (next > max) ? max : next;
+		}
+
+		return (size);
+	}
+
+	// A heap that could not be set up gives its memory back (retained list, superblock or kernel)
+	static void *heap_discard(t_arena *arena, t_heap *retained, t_superblock *superblock, void *ptr, size_t size) {
+		if (retained) {
+			retained->retained = true;
+			STATS_ADD(arena->retained, size);
+		} else if (superblock) superblock_release(arena, superblock, ptr, size);
+		else if (!munmap(ptr, size)) STATS_SUB(arena->stats.mapped, size);
+
+		return (NULL);
+	}
+
 	void *heap_create(t_arena *arena, int type, size_t size, size_t alignment) {
 		if (!arena || !size || type < TINY || type > LARGE) return (NULL);
 
 		size_t user_size = ALIGN(size + sizeof(t_chunk));
-		if		(type == TINY)	size = TINY_SIZE;
-		else if (type == SMALL)	size = SMALL_SIZE;
-		else					size = (((alignment >= PAGE_SIZE) ? PAGE_SIZE : 0) + alignment + size + sizeof(t_chunk) + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1);
+		if (type == LARGE) size = (((alignment >= PAGE_SIZE) ? PAGE_SIZE : 0) + alignment + size + sizeof(t_chunk) + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1);
 
-		void *ptr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
-		if (ptr == MAP_FAILED) {
-			if (print_log(1) && type != LARGE) aprintf(g_manager.options.fd_out, 1, "\t\t  [ERROR] Failed to create heap of size %s (%d)\n", (type == TINY ? "TINY" : "SMALL"), size);
-			return (NULL);
+		// Retained heap (reused with its own heap info, the page map already points to it)
+		void			*ptr = NULL;
+		t_heap			*retained = heap_reuse(arena, type, size);
+		t_superblock	*superblock = NULL;
+		bool			dirty = (retained != NULL);
+
+		if (retained) {
+			ptr = retained->ptr - retained->padding;
+			size = retained->size + retained->padding;
+		} else {
+			if (type != LARGE) size = heap_next_size(arena, type);
+
+			// TINY/SMALL heaps are carved out of a superblock (own mapping if it does not fit)
+			if (type == TINY || type == SMALL) ptr = superblock_take(arena, size, &superblock, &dirty);
+			if (!ptr) ptr = heap_map(&size, false);
+			if (ptr == MAP_FAILED) {
+				if (print_log(1) && type != LARGE) aprintf(g_manager.options.fd_out, 1, "\t\t  [ERROR] Failed to create heap of size %s (%d)\n", (type == TINY ? "TINY" : type == SMALL ? "SMALL" : "MEDIUM"), size);
+				return (NULL);
+			}
+			if (!superblock) STATS_ADD(arena->stats.mapped, size);
 		}
 
 		t_heap	*heap = NULL;
 
 		size_t padding = (alignment >= sizeof(t_chunk)) ? alignment - sizeof(t_chunk) : 0;
 		if (padding && ((uintptr_t)ptr % alignment) != 0) {
-			if (((uintptr_t)ptr % alignment) + padding + user_size > size) return (NULL);
+			if (((uintptr_t)ptr % alignment) + padding + user_size > size) return (heap_discard(arena, retained, superblock, ptr, size));
 			padding += (uintptr_t)ptr % alignment;
 		}
 
-		if (!arena->heap_header) {
+		if (retained) {
+			heap = retained;
+			heap->ptr = (void *)((char *)ptr + padding);
+			heap->padding = padding;
+			heap->size = size - padding;
+			heap->free = size - padding;
+			heap->type = type;
+			heap->active = true;
+			heap->free_chunks = 1;
+			heap->top_chunk = heap->ptr;
+		} else if (!arena->heap_header) {
 			if (arena == &g_manager.arena) {
 				t_heap_header *heap_header = internal_alloc(PAGE_SIZE);
-				if (!heap_header) return (NULL);
+				if (!heap_header) return (heap_discard(arena, retained, superblock, ptr, size));
 				arena->heap_header = heap_header;
-				heap_header->total = 85;
+				heap_header->total = heap_header_total(PAGE_SIZE);
 				heap_header->used = 1;
 				heap_header->next = NULL;
 
@@ -113,7 +302,7 @@
 			} else {
 				t_heap_header *heap_header = (t_heap_header *)((char *)arena + ALIGN(sizeof(t_arena)));
 				arena->heap_header = heap_header;
-				heap_header->total = 40;
+				heap_header->total = heap_header_total(PAGE_SIZE - ALIGN(sizeof(t_arena)));
 				heap_header->used = 1;
 				heap_header->next = NULL;
 
@@ -138,9 +327,9 @@
 
 			if (!found) {
 				t_heap_header *new_heap_header = internal_alloc(PAGE_SIZE);
-				if (!heap_header) return (NULL);
+				if (!new_heap_header) return (heap_discard(arena, retained, superblock, ptr, size));
 				heap_header->next = new_heap_header;
-				new_heap_header->total = 85;
+				new_heap_header->total = heap_header_total(PAGE_SIZE);
 				new_heap_header->used = 1;
 				new_heap_header->next = NULL;
 
@@ -168,10 +357,30 @@
 			}
 		}
 
-		t_chunk *chunk = heap->ptr;
-		chunk->size = (heap->size - sizeof(t_chunk)) | PREV_INUSE | (type == SMALL ? HEAP_TYPE : 0) | TOP_CHUNK | (type == LARGE ? MMAP_CHUNK : 0);
-		SET_MAGIC(GET_PTR(chunk));
-		if (print_log(2) && type != LARGE) aprintf(g_manager.options.fd_out, 1, "%p\t [SYSTEM] Heap of size %s (%d) allocated\n", heap->ptr, (type == TINY ? "TINY" : "SMALL"), heap->size);
+		heap->arena = arena;
+		heap->slabs = NULL;
+		heap->retained = false;
+		if (!retained) heap->superblock = superblock;
+		heap->dirty = dirty;
+		heap->untouched = (dirty) ? (char *)heap->ptr + heap->size : heap->ptr;
+		if (!retained && pagemap_set(ptr, size, heap)) {
+			heap->active = false;
+			heap_unmap(heap);
+			return (NULL);
+		}
+
+		STATS_ADD(arena->stats.heaps[type], 1);
+		if (type == LARGE) STATS_ADD(arena->stats.large, size);
+		thread_cache.path = (type == LARGE) ? LAT_MMAP : LAT_HEAP;
+
+		// TINY heaps are split in slabs (top_chunk is the first unused slab)
+		if (type != TINY) {
+			t_chunk *chunk = heap->ptr;
+			chunk->size = (heap->size - sizeof(t_chunk)) | PREV_INUSE | (type != LARGE ? HEAP_TYPE : 0) | TOP_CHUNK | (type == LARGE ? MMAP_CHUNK : 0);
+			SET_MAGIC(GET_PTR(chunk));
+		}
+		if (print_log(2) && type != LARGE) aprintf(g_manager.options.fd_out, 1, "%p\t [SYSTEM] Heap of size %s (%d) allocated\n", heap->ptr, (type == TINY ? "TINY" : type == SMALL ? "SMALL" : "MEDIUM"), heap->size);
+		if (g_manager.options.TRACING && type != LARGE) trace_event(TRACE_HEAP_CREATE, heap->ptr, heap->size, type);
 
 		if (heap && type == LARGE) return (GET_PTR(heap->ptr));
 
@@ -180,22 +389,83 @@
 
 #pragma endregion
 
+#pragma region "Remap"
+
+	void *heap_remap(t_heap *heap, size_t size) {
+		if (!heap || !heap->active || heap->type != LARGE) return (NULL);
+		if (size > SIZE_MAX - sizeof(t_chunk) - PAGE_SIZE) return (NULL);
+
+		void	*old_ptr = heap->ptr - heap->padding;
+		size_t	old_size = heap->size + heap->padding;
+		size_t	new_size = (heap->padding + size + sizeof(t_chunk) + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1);
+		void	*ptr = MAP_FAILED;
+
+		if (new_size == old_size) return (GET_PTR(heap->ptr));
+
+		// Shrink in place (the pages after the new end go back to the system)
+		if (new_size < old_size) {
+			ptr = mremap(old_ptr, old_size, new_size, 0);
+			if (ptr == MAP_FAILED) return (NULL);
+		}
+
+		// Grow in place (only the new pages need the page map)
+		if (ptr == MAP_FAILED) {
+			if (heap->padding >= PAGE_SIZE) return (NULL);
+
+			ptr = mremap(old_ptr, old_size, new_size, 0);
+			if (ptr != MAP_FAILED && pagemap_set((char *)ptr + old_size, new_size - old_size, heap)) {
+				mremap(ptr, new_size, old_size, 0);
+				return (NULL);
+			}
+		}
+
+		// Move (the destination is reserved first so the page map is ready before the pages move)
+		if (ptr == MAP_FAILED) {
+			void *dest = mmap(NULL, new_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+			if (dest == MAP_FAILED) return (NULL);
+			if (pagemap_set(dest, new_size, heap)) { munmap(dest, new_size); return (NULL); }
+
+			ptr = mremap(old_ptr, old_size, new_size, MREMAP_MAYMOVE | MREMAP_FIXED, dest);
+			if (ptr == MAP_FAILED) { munmap(dest, new_size); return (NULL); }
+		}
+
+		heap->ptr = (char *)ptr + heap->padding;
+		heap->size = new_size - heap->padding;
+		heap->free = heap->size;
+		heap->top_chunk = heap->ptr;
+		STATS_ADD(heap->arena->stats.mapped, new_size - old_size);
+		STATS_ADD(heap->arena->stats.large, new_size - old_size);
+
+		t_chunk *chunk = heap->ptr;
+		chunk->size = (heap->size - sizeof(t_chunk)) | (chunk->size & 15);
+
+		if (print_log(2)) aprintf(g_manager.options.fd_out, 1, "%p	 [SYSTEM] LARGE heap remapped from %d to %d bytes\n", heap->ptr, old_size, new_size);
+
+		return (GET_PTR(heap->ptr));
+	}
+
+#pragma endregion
+
 #pragma region "Destroy"
 
 	int heap_destroy(t_heap *heap) {
 		if (!heap) return (1);
 
 		int result = 0;
-		if (munmap(heap->ptr - heap->padding, heap->size + heap->padding)) {
+		if (heap_retain(heap) && heap_unmap(heap)) {
 			result = 1;
 			if (print_log(1) && heap->type == LARGE)		aprintf(g_manager.options.fd_out, 1, "%p\t  [ERROR] Failed to unmap memory of size %d bytes\n", heap->ptr, heap->size);
-			if (print_log(1) && heap->type != LARGE)		aprintf(g_manager.options.fd_out, 1, "%p\t  [ERROR] Failed to detroy heap of size %s (%d)\n", heap->ptr, (heap->type == TINY ? "TINY" : "SMALL"), heap->size);
+			if (print_log(1) && heap->type != LARGE)		aprintf(g_manager.options.fd_out, 1, "%p\t  [ERROR] Failed to detroy heap of size %s (%d)\n", heap->ptr, (heap->type == TINY ? "TINY" : heap->type == SMALL ? "SMALL" : "MEDIUM"), heap->size);
 		}
 
 		heap->active = false;
+		STATS_SUB(heap->arena->stats.heaps[heap->type], 1);
+		if (heap->type == LARGE) STATS_SUB(heap->arena->stats.large, heap->size + heap->padding);
+		thread_cache.path = (heap->type == LARGE) ? LAT_MMAP : LAT_HEAP;
 
 		if (!result && heap->type == LARGE && print_log(0)) aprintf(g_manager.options.fd_out, 1, "%p\t   [FREE] Memory freed of size %d bytes\n", heap->ptr, heap->size);
-		if (!result && heap->type != LARGE && print_log(2)) aprintf(g_manager.options.fd_out, 1, "%p\t [SYSTEM] Heap of size %s (%d) freed\n", heap->ptr, (heap->type == TINY ? "TINY" : "SMALL"), heap->size);
+		if (!result && heap->type != LARGE && print_log(2)) aprintf(g_manager.options.fd_out, 1, "%p\t [SYSTEM] Heap of size %s (%d) freed\n", heap->ptr, (heap->type == TINY ? "TINY" : heap->type == SMALL ? "SMALL" : "MEDIUM"), heap->size);
+		if (!result && heap->type != LARGE && g_manager.options.TRACING) trace_event(TRACE_HEAP_FREE, heap->ptr, heap->size, heap->type);
 
 		return (result);
 	}
@@ -0,0 +1,178 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   latency.c                                          :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vzurera- <vzurera-@student.42malaga.com    +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 20:05:31 by vzurera-          #+#    #+#             */
+/*   Updated: 2026/10/17 20:05:31 by vzurera-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#pragma region "Includes"
+
+	#include "arena.h"
+
+#pragma endregion
+
+#pragma region "Ticks"
+
+	static uint64_t latency_time() {
+		struct timespec ts;
+
+		if (clock_gettime(CLOCK_MONOTONIC, &ts)) return (0);
+
+		return (((uint64_t)ts.tv_sec * 1000000000ULL) + ts.tv_nsec);
+	}
+
+	uint64_t latency_ticks() {
+		#if defined(__x86_64__) || defined(__i386__)
+			return (__builtin_ia32_rdtsc());
+		#else
+			return (latency_time());
+		#endif
+	}
+
+	double latency_scale() {
+		uint64_t start_ticks = __atomic_load_n(&g_manager.latency_ticks, __ATOMIC_ACQUIRE);
+		uint64_t start_ns = __atomic_load_n(&g_manager.latency_ns, __ATOMIC_RELAXED);
+		uint64_t now_ns;
+
+		if (!start_ticks) return (1.0);
+
+		// Ticks are compared with the clock over at least 10 ms, so the ratio is accurate
+		while ((now_ns = latency_time()) - start_ns < 10000000ULL) ;
+
+		uint64_t now_ticks = latency_ticks();
+		if (now_ticks <= start_ticks) return (1.0);
+
+		return ((double)(now_ns - start_ns) / (double)(now_ticks - start_ticks));
+	}
+
+#pragma endregion
+
+#pragma region "Get"
+
+	static t_latency *latency_get() {
+		t_latency *latency = NULL;
+
+		mutex(&g_manager.mutex, MTX_LOCK);
+
+			// A histogram released by an exited thread is reused (its samples are kept)
+			for (latency = g_manager.latency; latency; latency = latency->next)
+				if (!__atomic_load_n(&latency->used, __ATOMIC_ACQUIRE)) break;
+
+			if (!latency && (latency = internal_alloc(sizeof(t_latency)))) {
+				latency->next = g_manager.latency;
+				__atomic_store_n(&g_manager.latency, latency, __ATOMIC_RELEASE);
+			}
+			if (latency) latency->used = 1;
+
+			if (!g_manager.latency_ticks) {
+				g_manager.latency_ns = latency_time();
+				__atomic_store_n(&g_manager.latency_ticks, latency_ticks(), __ATOMIC_RELEASE);
+			}
+
+		mutex(&g_manager.mutex, MTX_UNLOCK);
+
+		return (latency);
+	}
+
+#pragma endregion
+
+#pragma region "Sample"
+
+	bool latency_sample() {
+		if (thread_cache.sampling || ++thread_cache.samples < (uint32_t)g_manager.options.LATENCY) return (false);
+
+		thread_cache.samples = 0;
+		if (!thread_cache.latency && !(thread_cache.latency = latency_get())) return (false);
+
+		// Only the slow paths set the path, so a call that does not change it was served by the thread cache
+		thread_cache.sampling = true;
+		thread_cache.path = LAT_CACHE;
+
+		return (true);
+	}
+
+#pragma endregion
+
+#pragma region "Type"
+
+	int latency_type(void *ptr) {
+		t_heap *heap = (ptr && !((uintptr_t)ptr % ALIGNMENT)) ? pagemap_get(ptr) : NULL;
+
+		return ((heap) ? heap->type : -1);
+	}
+
+#pragma endregion
+
+#pragma region "Record"
+
+	void latency_record(int op, int type, uint64_t ticks) {
+		// The TSC of another CPU can be behind (the thread migrated during the call)
+		int bucket = ((int64_t)ticks > 0) ? LATENCY_BUCKET(ticks) : 0;
+
+		thread_cache.sampling = false;
+		if (type < TINY || type > LARGE || !thread_cache.latency) return ;
+		if (bucket >= LATENCY_BUCKETS) bucket = LATENCY_BUCKETS - 1;
+
+		// Only the owner thread writes its histogram
+		uint32_t *count = &thread_cache.latency->counts[op][type][thread_cache.path][bucket];
+		__atomic_store_n(count, *count + 1, __ATOMIC_RELAXED);
+	}
+
+#pragma endregion
+
+#pragma region "Release"
+
+	void latency_release() {
+		if (!thread_cache.latency) return ;
+
+		__atomic_store_n(&thread_cache.latency->used, 0, __ATOMIC_RELEASE);
+		thread_cache.latency = NULL;
+		thread_cache.samples = 0;
+	}
+
+#pragma endregion
+
+#pragma region "Total"
+
+	int latency_total(t_latency *total) {
+		if (!total) return (0);
+
+		t_latency	*latency = __atomic_load_n(&g_manager.latency, __ATOMIC_ACQUIRE);
+		int			count = 0;
+
+		ft_memset(total, 0, sizeof(t_latency));
+
+		for (; latency; latency = latency->next, ++count) {
+			for (int op = 0; op < LATENCY_OPS; ++op)
+				for (int type = TINY; type <= LARGE; ++type)
+					for (int path = 0; path < LATENCY_PATHS; ++path)
+						for (int i = 0; i < LATENCY_BUCKETS; ++i)
+							total->counts[op][type][path][i] += __atomic_load_n(&latency->counts[op][type][path][i], __ATOMIC_RELAXED);
+		}
+
+		return (count);
+	}
+
+#pragma endregion
+
+#pragma region "Information"
+
+	// Latency histograms of malloc(), free() and realloc() (MALLOC_LATENCY / M_LATENCY).
+	//
+	//   • One call in MALLOC_LATENCY of each thread is timed with the TSC (clock_gettime() on other architectures).
+	//   • Samples go to a histogram of the thread, by operation, heap type and internal path, in buckets of powers of two.
+	//   • Paths: thread cache, bin (or slab with free objects), split of a top chunk (or new slab), new heap and mmap.
+	//   • show_alloc_latency() adds up the histograms of every thread and converts ticks to ns.
+	//
+	// Notes:
+	//   • When disabled, the only cost is one load and a branch per call (histograms are not even created).
+	//   • Histograms are created on the first sample of a thread, and reused by new threads when a thread exits.
+	//   • The ratio of ticks to ns is measured from the first sample to the dump (at least 10 ms).
+	//   • Calls made from a sampled call (the malloc and free of a moving realloc) are part of its sample.
+
+#pragma endregion
@@ -0,0 +1,223 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   profile.c                                          :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vzurera- <vzurera-@student.42malaga.com    +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 00:21:36 by vzurera-          #+#    #+#             */
+/*   Updated: 2026/10/18 00:21:36 by vzurera-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#pragma region "Includes"
+
+	#define _GNU_SOURCE
+
+	#include "arena.h"
+
+	#include <execinfo.h>
+
+#pragma endregion
+
+#pragma region "Interval"
+
+	// xorshift64* (one generator per thread, no locks)
+	static uint64_t profile_random() {
+		uint64_t x = thread_cache.profile_seed;
+
+		x ^= x >> 12;
+		x ^= x << 25;
+		x ^= x >> 27;
+		thread_cache.profile_seed = x;
+
+		return (x * 0x2545F4914F6CDD1DULL);
+	}
+
+	// Natural logarithm of x >= 1 (without libm: exponent from the bits of the double, series for the mantissa)
+	static double profile_log(double x) {
+		union { double d; uint64_t u; } bits = { .d = x };
+		int exponent = (int)((bits.u >> 52) & 0x7FF) - 1023;
+
+		bits.u = (bits.u & 0xFFFFFFFFFFFFFULL) | (1023ULL << 52);
+		double t = (bits.d - 1.0) / (bits.d + 1.0), t2 = t * t;
+
+		return (exponent * 0.6931471805599453 + 2.0 * t * (1.0 + t2 * (1.0 / 3 + t2 * (1.0 / 5 + t2 * (1.0 / 7 + t2 / 9)))));
+	}
+
+	// Exponential gap with a mean of PROFILE bytes, so every allocated byte has the same chance of being sampled
+	static int64_t profile_interval() {
+		double q = (double)(profile_random() >> 11) + 1.0;
+		double gap = (53 * 0.6931471805599453 - profile_log(q)) * g_manager.options.PROFILE;
+
+		return ((gap < 1.0) ? 1 : (int64_t)gap);
+	}
+
+#pragma endregion
+
+#pragma region "Get"
+
+	static t_profile *profile_get() {
+		t_profile *profile = __atomic_load_n(&g_manager.profile, __ATOMIC_ACQUIRE);
+
+		if (profile || !(profile = internal_alloc(sizeof(t_profile)))) return (profile);
+
+		// Created by the first thread that takes a sample
+		t_profile *expected = NULL;
+		if (!__atomic_compare_exchange_n(&g_manager.profile, &expected, profile, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+			internal_free(profile, sizeof(t_profile));
+			profile = expected;
+		}
+
+		return (profile);
+	}
+
+#pragma endregion
+
+#pragma region "Stack"
+
+	static int profile_backtrace(void **frames) {
+		void	*raw[PROFILE_DEPTH + 8];
+		int		count = backtrace(raw, PROFILE_DEPTH + 8);
+		int		skip = 0;
+		Dl_info	self, info;
+
+		// Frames of the allocator are skipped, so the first one is the caller of malloc(), calloc()...
+		if (dladdr((void *)profile_alloc, &self))
+			while (skip < count && dladdr(raw[skip], &info) && info.dli_fbase == self.dli_fbase) skip++;
+		if (skip == count) skip = 0;
+
+		int depth = ft_min(count - skip, PROFILE_DEPTH);
+		for (int i = 0; i < depth; ++i) frames[i] = raw[skip + i];
+
+		return (depth);
+	}
+
+	static int profile_stack(t_profile *profile, void **frames, int depth) {
+		uint64_t hash = 0xCBF29CE484222325ULL;
+
+		for (int i = 0; i < depth; ++i) hash = (hash ^ (uintptr_t)frames[i]) * 0x100000001B3ULL;
+		if (hash < 2) hash += 2;
+
+		for (size_t i = 0; i < PROFILE_STACKS; ++i) {
+			size_t			index = (hash + i) % PROFILE_STACKS;
+			t_profile_stack	*stack = &profile->stacks[index];
+			uint64_t		current = __atomic_load_n(&stack->hash, __ATOMIC_ACQUIRE);
+
+			if (current == hash && stack->depth == (uint32_t)depth) {
+				int same = 1;
+				for (int j = 0; same && j < depth; ++j) same = (stack->frames[j] == frames[j]);
+				if (same) return ((int)index);
+			}
+
+			// Slot being written by another thread (the same stack can end up in two slots, the dump shows both)
+			if (current) continue;
+
+			uint64_t expected = 0;
+			if (!__atomic_compare_exchange_n(&stack->hash, &expected, 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) { --i; continue; }
+
+			stack->depth = depth;
+			for (int j = 0; j < depth; ++j) stack->frames[j] = frames[j];
+			__atomic_store_n(&stack->hash, hash, __ATOMIC_RELEASE);
+
+			return ((int)index);
+		}
+
+		return (-1);
+	}
+
+#pragma endregion
+
+#pragma region "Alloc"
+
+	void profile_alloc(void *ptr, size_t size) {
+		if (!ptr || thread_cache.profiling) return ;
+
+		// First allocation of the thread: only draws the first interval
+		if (!thread_cache.profile_seed) {
+			thread_cache.profile_seed = (latency_ticks() ^ (uintptr_t)&thread_cache) | 1;
+			if ((thread_cache.profile_left += profile_interval()) >= 0) return ;
+		}
+
+		thread_cache.profile_left = profile_interval();
+
+		t_profile *profile = profile_get();
+		if (!profile) return ;
+
+		// backtrace() can allocate (the first call loads libgcc_s), those allocations are not sampled
+		void *frames[PROFILE_DEPTH];
+
+		thread_cache.profiling = true;
+			int index = profile_stack(profile, frames, profile_backtrace(frames));
+		thread_cache.profiling = false;
+
+		if (index < 0) return ;
+
+		t_profile_stack	*stack = &profile->stacks[index];
+		size_t			first = PROFILE_BUCKET(ptr);
+
+		__atomic_add_fetch(&stack->total_count, 1, __ATOMIC_RELAXED);
+		__atomic_add_fetch(&stack->total_bytes, size, __ATOMIC_RELAXED);
+
+		// The slot is claimed with the low bit set, and published once the sample is written
+		for (size_t i = first; i < first + PROFILE_WAYS; ++i) {
+			uintptr_t expected = 0;
+			if (!__atomic_compare_exchange_n(&profile->ptrs[i], &expected, (uintptr_t)ptr | 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) continue;
+
+			profile->samples[i].size = size;
+			profile->samples[i].stack = index;
+			__atomic_add_fetch(&stack->live_count, 1, __ATOMIC_RELAXED);
+			__atomic_add_fetch(&stack->live_bytes, size, __ATOMIC_RELAXED);
+			__atomic_add_fetch(&profile->used[first / PROFILE_WAYS], 1, __ATOMIC_RELAXED);
+			__atomic_store_n(&profile->ptrs[i], (uintptr_t)ptr, __ATOMIC_RELEASE);
+			return ;
+		}
+	}
+
+#pragma endregion
+
+#pragma region "Free"
+
+	void profile_free(void *ptr) {
+		t_profile	*profile = __atomic_load_n(&g_manager.profile, __ATOMIC_ACQUIRE);
+		size_t		first = PROFILE_BUCKET(ptr);
+
+		if (!profile || !__atomic_load_n(&profile->used[first / PROFILE_WAYS], __ATOMIC_RELAXED)) return ;
+
+		for (size_t i = first; i < first + PROFILE_WAYS; ++i) {
+			if (__atomic_load_n(&profile->ptrs[i], __ATOMIC_ACQUIRE) != (uintptr_t)ptr) continue;
+
+			// Read before the slot is released (a new sample can take it right after)
+			t_profile_sample	sample = profile->samples[i];
+			uintptr_t			expected = (uintptr_t)ptr;
+
+			if (!__atomic_compare_exchange_n(&profile->ptrs[i], &expected, 0, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) return ;
+
+			__atomic_sub_fetch(&profile->stacks[sample.stack].live_count, 1, __ATOMIC_RELAXED);
+			__atomic_sub_fetch(&profile->stacks[sample.stack].live_bytes, sample.size, __ATOMIC_RELAXED);
+			__atomic_sub_fetch(&profile->used[first / PROFILE_WAYS], 1, __ATOMIC_RELAXED);
+			return ;
+		}
+	}
+
+#pragma endregion
+
+#pragma region "Information"
+
+	// Sampling heap profiler (MALLOC_PROFILE / M_PROFILE).
+	//
+	//   • Each thread counts down the bytes it allocates. When the count goes below zero the allocation is sampled,
+	//     and the next gap is drawn from an exponential distribution with a mean of PROFILE bytes.
+	//   • A sample captures the call stack with backtrace(), adds it to the totals of that stack, and keeps the
+	//     pointer in a table of live samples until it is freed.
+	//   • The tables have a fixed size and are updated with atomic operations only (no locks).
+	//   • malloc_profile_dump() writes the live and total samples of each stack.
+	//
+	// Notes:
+	//   • Allocations that are not sampled only pay the countdown, and free() only looks in the table when the
+	//     bucket of the pointer has samples.
+	//   • A sample whose bucket is full counts in the totals only, and one with a new stack when all stacks are
+	//     taken is not recorded.
+	//   • In-place reallocs are handled as a free and a new allocation of the new size.
+
+#pragma endregion
@@ -0,0 +1,226 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   slab.c                                             :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vzurera- <vzurera-@student.42malaga.com    +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 12:20:05 by vzurera-          #+#    #+#             */
+/*   Updated: 2026/10/17 12:20:05 by vzurera-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#pragma region "Includes"
+
+	#include "arena.h"
+
+#pragma endregion
+
+#pragma region "List"
+
+	static void slab_link(t_arena *arena, t_slab *slab) {
+		int index = SLAB_CLASS(slab->size);
+
+		slab->prev = NULL;
+		slab->next = arena->slabs[index];
+		if (slab->next) slab->next->prev = slab;
+		arena->slabs[index] = slab;
+	}
+
+	static void slab_unlink(t_arena *arena, t_slab *slab) {
+		int index = SLAB_CLASS(slab->size);
+
+		if (slab->prev)	slab->prev->next = slab->next;
+		else			arena->slabs[index] = slab->next;
+		if (slab->next)	slab->next->prev = slab->prev;
+
+		slab->next = NULL;
+		slab->prev = NULL;
+	}
+
+#pragma endregion
+
+#pragma region "Create"
+
+	static t_slab *slab_take(t_heap *heap) {
+		t_slab *slab = heap->slabs;
+
+		if (slab) heap->slabs = slab->next;
+		else if ((char *)heap->top_chunk + SLAB_SIZE <= (char *)heap->ptr + heap->size) {
+			slab = (t_slab *)heap->top_chunk;
+			heap->top_chunk = (t_chunk *)((char *)heap->top_chunk + SLAB_SIZE);
+		}
+
+		return (slab);
+	}
+
+	static t_slab *slab_create(t_arena *arena, size_t size) {
+		t_slab			*slab = NULL;
+		t_heap			*heap = NULL;
+		t_heap_header	*heap_header = arena->heap_header;
+
+		while (heap_header && !slab) {
+			heap = (t_heap *)((char *)heap_header + ALIGN(sizeof(t_heap_header)));
+
+			for (int i = 0; i < heap_header->used && !slab; ++i) {
+				if (heap->active && heap->type == TINY) slab = slab_take(heap);
+				if (!slab) heap = (t_heap *)((char *)heap + ALIGN(sizeof(t_heap)));
+			}
+
+			heap_header = heap_header->next;
+		}
+
+		if (!slab) {
+			heap = (t_heap *)heap_create(arena, TINY, TINY_SIZE, 0);
+			if (!heap) return (NULL);
+			slab = slab_take(heap);
+			if (!slab) return (NULL);
+		}
+
+		slab->heap = heap;
+		slab->size = size;
+		slab->count = (SLAB_SIZE - ALIGN(sizeof(t_slab))) / size;
+		slab->used = 0;
+
+		ft_memset(slab->map, 0, sizeof(slab->map));
+		ft_memset(slab->cached, 0, sizeof(slab->cached));
+		for (int i = 0; i < slab->count; ++i) slab->map[i / 64] |= (uint64_t)1 << (i % 64);
+
+		slab_link(arena, slab);
+
+		if (print_log(2)) aprintf(g_manager.options.fd_out, 1, "%p\t [SYSTEM] Slab of size %u bytes created\n", slab, size);
+
+		return (slab);
+	}
+
+#pragma endregion
+
+#pragma region "Alloc"
+
+	void *slab_alloc(t_arena *arena, size_t size) {
+		if (!arena || !size || size > TINY_CHUNK) return (NULL);
+
+		size = ALIGN(size);
+		t_slab *slab = arena->slabs[SLAB_CLASS(size)];
+		if (!slab) slab = slab_create(arena, size);
+		if (!slab) return (NULL);
+
+		int word = 0;
+		while (!slab->map[word]) word++;
+
+		int index = (word * 64) + __builtin_ctzll(slab->map[word]);
+		slab->map[word] &= ~((uint64_t)1 << (index % 64));
+		slab->used++;
+		slab->heap->free -= size;
+		STATS_ADD(arena->stats.in_use, size);
+
+		if (slab->used == slab->count) slab_unlink(arena, slab);
+
+		return (SLAB_START(slab) + (index * size));
+	}
+
+#pragma endregion
+
+#pragma region "Check"
+
+	int slab_check(void *ptr, t_heap *heap) {
+		if (!ptr || !heap || heap->type != TINY) return (1);
+
+		t_slab *slab = GET_SLAB(ptr);
+		if ((void *)slab < heap->ptr || (void *)slab >= (void *)heap->top_chunk) return (1);
+		if (!slab->size || slab->heap != heap || (char *)ptr < SLAB_START(slab)) return (1);
+
+		size_t offset = (char *)ptr - SLAB_START(slab);
+		if (offset % slab->size || offset / slab->size >= slab->count) return (1);
+
+		int index = offset / slab->size;
+		if (slab->map[index / 64] & ((uint64_t)1 << (index % 64))) return (1);
+
+		return (0);
+	}
+
+#pragma endregion
+
+#pragma region "Usable"
+
+	size_t slab_usable(void *ptr, t_heap *heap) {
+		if (slab_check(ptr, heap)) return (0);
+
+		return (GET_SLAB(ptr)->size);
+	}
+
+#pragma endregion
+
+#pragma region "Free"
+
+	int slab_free(t_arena *arena, void *ptr, t_heap *heap) {
+		if (!arena || !ptr || !heap) return (0);
+
+		t_slab *slab = GET_SLAB(ptr);
+		bool valid = (void *)slab >= heap->ptr && (void *)slab < (void *)heap->top_chunk && slab->size && slab->heap == heap && (char *)ptr >= SLAB_START(slab);
+		size_t offset = valid ? (size_t)((char *)ptr - SLAB_START(slab)) : 0;
+
+		// Middle object
+		if (!valid || offset % slab->size || offset / slab->size >= slab->count) {
+			if (print_log(1))				aprintf(g_manager.options.fd_out, 1, "%p\t  [ERROR] Invalid pointer (free: in middle of chunk (TINY))\n", ptr);
+			if (print_error())				aprintf(2, 0, "free: Invalid pointer\n");
+			return (abort_now());
+		}
+
+		// Double free
+		int index = offset / slab->size;
+		if (slab->map[index / 64] & ((uint64_t)1 << (index % 64))) {
+			if (print_log(1))				aprintf(g_manager.options.fd_out, 1, "%p\t  [ERROR] Double free (free: bitmap)\n", ptr);
+			if (print_error())				aprintf(2, 0, "free: Double free\n");
+			return (abort_now());
+		}
+
+		size_t size = slab->size;
+		if (g_manager.options.PERTURB) ft_memset(ptr, g_manager.options.PERTURB, size);
+
+		if (slab->used == slab->count) slab_link(arena, slab);
+		slab->map[index / 64] |= (uint64_t)1 << (index % 64);
+		slab->used--;
+		heap->free += size;
+
+		arena->free_count++;
+		STATS_SUB(arena->stats.in_use, size);
+		STATS_ADD(arena->stats.frees[STATS_CLASS(size)], 1);
+
+		// Empty slab (keep one per size class)
+		if (!slab->used && (arena->slabs[SLAB_CLASS(size)] != slab || slab->next)) {
+			slab_unlink(arena, slab);
+			slab->size = 0;
+			slab->next = heap->slabs;
+			heap->slabs = slab;
+		}
+
+		if (heap->free >= heap->size && heap_can_removed(arena, heap)) {
+			for (char *page = heap->ptr; page < (char *)heap->top_chunk; page += SLAB_SIZE) {
+				if (((t_slab *)page)->size) slab_unlink(arena, (t_slab *)page);
+			}
+			heap_destroy(heap);
+		}
+
+		if (print_log(0)) aprintf(g_manager.options.fd_out, 1, "%p\t   [FREE] Memory freed of size %d bytes\n", ptr, size);
+
+		return (0);
+	}
+
+#pragma endregion
+
+#pragma region "Information"
+
+	// Size-class allocator for TINY requests (up to TINY_CHUNK bytes).
+	//
+	//   • TINY heaps are split in slabs of SLAB_SIZE bytes, each one holding objects of a single size class.
+	//   • Objects have no header: the page map gives the heap and the slab header sits at the start of the page.
+	//   • A bitmap in the slab header tracks the free objects, so a double free is found without touching the object.
+	//   • Slabs with free objects are kept in a list per size class in the arena.
+	//   • Empty slabs go back to their heap and can be reused by any size class (one is kept per class to avoid thrashing).
+	//
+	// Notes:
+	//   • In TINY heaps, top_chunk is not a chunk: it points to the first slab that was never used.
+	//   • Without a header there is no magic to check, so an overflow into the next object is not reported.
+
+#pragma endregion
@@ -0,0 +1,87 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   stats.c                                            :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vzurera- <vzurera-@student.42malaga.com    +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 19:12:40 by vzurera-          #+#    #+#             */
+/*   Updated: 2026/10/17 19:12:40 by vzurera-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#pragma region "Includes"
+
+	#include "arena.h"
+
+#pragma endregion
+
+#pragma region "Load"
+
+	void stats_load(t_arena *arena, t_stats *stats) {
+		if (!arena || !stats) return ;
+
+		stats->in_use = __atomic_load_n(&arena->stats.in_use, __ATOMIC_RELAXED);
+		stats->mapped = __atomic_load_n(&arena->stats.mapped, __ATOMIC_RELAXED);
+		stats->large = __atomic_load_n(&arena->stats.large, __ATOMIC_RELAXED);
+		for (int type = TINY; type <= LARGE; ++type)
+			stats->heaps[type] = __atomic_load_n(&arena->stats.heaps[type], __ATOMIC_RELAXED);
+		for (int i = 0; i < (int)STATS_CLASSES; ++i) {
+			stats->allocs[i] = __atomic_load_n(&arena->stats.allocs[i], __ATOMIC_RELAXED);
+			stats->frees[i] = __atomic_load_n(&arena->stats.frees[i], __ATOMIC_RELAXED);
+		}
+	}
+
+#pragma endregion
+
+#pragma region "Total"
+
+	int stats_total(t_stats *total, size_t *retained) {
+		if (!total) return (0);
+
+		t_arena	*arena = &g_manager.arena;
+		int		arena_count = __atomic_load_n(&g_manager.arena_count, __ATOMIC_ACQUIRE);
+		int		count = 0;
+
+		ft_memset(total, 0, sizeof(t_stats));
+		if (retained) *retained = 0;
+
+		for (; count < arena_count && arena; ++count) {
+			t_stats stats;
+
+			stats_load(arena, &stats);
+			total->in_use += stats.in_use;
+			total->mapped += stats.mapped;
+			total->large += stats.large;
+			for (int type = TINY; type <= LARGE; ++type) total->heaps[type] += stats.heaps[type];
+			for (int i = 0; i < (int)STATS_CLASSES; ++i) {
+				total->allocs[i] += stats.allocs[i];
+				total->frees[i] += stats.frees[i];
+			}
+			if (retained) *retained += __atomic_load_n(&arena->retained, __ATOMIC_RELAXED);
+
+			arena = __atomic_load_n(&arena->next, __ATOMIC_ACQUIRE);
+		}
+
+		return (count);
+	}
+
+#pragma endregion
+
+#pragma region "Information"
+
+	// Counters of each arena, read without taking any lock (mallinfo2, malloc_stats and malloc_info).
+	//
+	//   • in_use:  bytes handed out by the arena (usable size). Blocks held in thread caches count as in use.
+	//   • mapped:  bytes mapped by the arena (heaps with their own mapping and superblocks, retained heaps included).
+	//   • large:   bytes mapped by active LARGE heaps.
+	//   • heaps:   active heaps of each type.
+	//   • allocs / frees: calls of each size class (powers of two, from 16 bytes).
+	//
+	// Notes:
+	//   • Counters are only written under the arena lock, so a plain add and an atomic store are enough (no locked instructions).
+	//   • Readers get each counter whole, but not a snapshot of all of them at the same instant.
+	//   • Allocations and frees served by a thread cache are added to the arena the next time the thread locks it.
+	//   • A block resized in place by realloc() is counted as freed in the size class of its new size.
+
+#pragma endregion
@@ -0,0 +1,147 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   superblock.c                                       :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vzurera- <vzurera-@student.42malaga.com    +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 16:40:12 by vzurera-          #+#    #+#             */
+/*   Updated: 2026/10/17 16:40:12 by vzurera-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#pragma region "Includes"
+
+	#include "arena.h"
+
+#pragma endregion
+
+#pragma region "Bitmap"
+
+	#define SB_GET(map, i)		((map)[(i) / 64] & (1ULL << ((i) % 64)))
+	#define SB_SET(map, i)		((map)[(i) / 64] |= (1ULL << ((i) % 64)))
+	#define SB_CLEAR(map, i)	((map)[(i) / 64] &= ~(1ULL << ((i) % 64)))
+
+	static int superblock_find(t_superblock *superblock, size_t pages) {
+		size_t total = SUPERBLOCK_SIZE / PAGE_SIZE;
+		size_t run = 0;
+
+		if (total - superblock->used < pages) return (-1);
+
+		// First fit (page 0 is the header)
+		for (size_t i = 1; i < total; ++i) {
+			if (SB_GET(superblock->map, i))	run = 0;
+			else if (++run == pages)		return ((int)(i - pages + 1));
+		}
+
+		return (-1);
+	}
+
+#pragma endregion
+
+#pragma region "Create"
+
+	static t_superblock *superblock_create(t_arena *arena) {
+		size_t			size = SUPERBLOCK_SIZE;
+		t_superblock	*superblock = heap_map(&size, true);
+
+		if (superblock == MAP_FAILED) {
+			if (print_log(1)) aprintf(g_manager.options.fd_out, 1, "\t\t  [ERROR] Failed to create superblock\n");
+			return (NULL);
+		}
+
+		superblock->used = 1;
+		SB_SET(superblock->map, 0);
+		STATS_ADD(arena->stats.mapped, SUPERBLOCK_SIZE);
+
+		superblock->prev = NULL;
+		superblock->next = arena->superblocks;
+		if (superblock->next) superblock->next->prev = superblock;
+		arena->superblocks = superblock;
+
+		if (print_log(2)) aprintf(g_manager.options.fd_out, 1, "%p\t [SYSTEM] Superblock created\n", superblock);
+
+		return (superblock);
+	}
+
+#pragma endregion
+
+#pragma region "Take"
+
+	void *superblock_take(t_arena *arena, size_t size, t_superblock **superblock, bool *dirty) {
+		if (!arena || !size || size > SUPERBLOCK_SIZE - PAGE_SIZE) return (NULL);
+
+		size_t			pages = (size + PAGE_SIZE - 1) / PAGE_SIZE;
+		t_superblock	*current = arena->superblocks;
+		int				first = -1;
+
+		while (current && (first = superblock_find(current, pages)) < 0) current = current->next;
+		if (!current) {
+			if (!(current = superblock_create(arena))) return (NULL);
+			first = 1;
+		}
+
+		*dirty = false;
+		for (size_t i = first; i < first + pages; ++i) {
+			if (SB_GET(current->dirty, i)) *dirty = true;
+			SB_CLEAR(current->dirty, i);
+			SB_SET(current->map, i);
+		}
+		current->used += pages;
+
+		*superblock = current;
+		return ((char *)current + first * PAGE_SIZE);
+	}
+
+#pragma endregion
+
+#pragma region "Release"
+
+	int superblock_release(t_arena *arena, t_superblock *superblock, void *ptr, size_t size) {
+		if (!arena || !superblock || !ptr) return (1);
+
+		size_t pages = (size + PAGE_SIZE - 1) / PAGE_SIZE;
+		size_t first = ((char *)ptr - (char *)superblock) / PAGE_SIZE;
+
+		for (size_t i = first; i < first + pages; ++i) SB_CLEAR(superblock->map, i);
+		superblock->used -= pages;
+
+		// Empty (unmapped)
+		if (superblock->used == 1) {
+			if (superblock->prev)	superblock->prev->next = superblock->next;
+			else					arena->superblocks = superblock->next;
+			if (superblock->next)	superblock->next->prev = superblock->prev;
+
+			if (munmap(superblock, SUPERBLOCK_SIZE)) {
+				if (print_log(1)) aprintf(g_manager.options.fd_out, 1, "%p\t  [ERROR] Failed to unmap superblock\n", superblock);
+				return (1);
+			}
+			STATS_SUB(arena->stats.mapped, SUPERBLOCK_SIZE);
+
+			if (print_log(2)) aprintf(g_manager.options.fd_out, 1, "%p\t [SYSTEM] Superblock freed\n", superblock);
+			return (0);
+		}
+
+		// Give the pages back (they read as zero the next time, unless the kernel refuses, as with hugetlbfs pages)
+		if (madvise(ptr, pages * PAGE_SIZE, MADV_DONTNEED))
+			for (size_t i = first; i < first + pages; ++i) SB_SET(superblock->dirty, i);
+
+		return (0);
+	}
+
+#pragma endregion
+
+#pragma region "Information"
+
+	// Superblocks are 2 MiB mappings, aligned to a huge page, that host the TINY and SMALL heaps of an arena.
+	//
+	//   • superblock_take() carves a heap out of the first run of free pages (first fit), creating a new superblock if none has room.
+	//   • superblock_release() gives the pages of a destroyed heap back with MADV_DONTNEED, and unmaps the superblock once it is empty.
+	//   • The first page of each superblock holds its header (bitmaps of used and dirty pages).
+	//
+	// Notes:
+	//   • Heaps bigger than a superblock (minus the header page) and MEDIUM/LARGE heaps keep their own mapping.
+	//   • Pages that could not be zeroed are marked as dirty, so calloc() does not trust them to be zero.
+	//   • With MALLOC_HUGE_PAGES the superblock is backed by huge pages, so small objects share a few TLB entries.
+
+#pragma endregion
@@ -20,6 +20,7 @@
 
 	t_manager			g_manager;
 	__thread t_arena	*tcache;
+	__thread t_cache	thread_cache;
 
 #pragma endregion
 
@@ -126,12 +127,17 @@
 		void child_fork() {
 			if (print_log(2)) aprintf(g_manager.options.fd_out, 1, "\t\t [SYSTEM] Child fork\n");
 
+			// Only the thread that called fork() exists in the child
 			t_arena *arena = &g_manager.arena;
 			while (arena) {
+				arena->threads = (arena == tcache);
+				arena->contention = 0;
 				mutex(&arena->mutex, MTX_UNLOCK);
 				arena = arena->next;
 			}
 			mutex(&g_manager.mutex, MTX_UNLOCK);
+
+			if (g_manager.options.TRACING) trace_fork();
 		}
 
 	#pragma endregion
@@ -206,6 +212,7 @@
 			mutex(&g_manager.mutex, MTX_INIT);
 			mutex(&g_manager.hist_mutex, MTX_INIT);
 			get_pagesize();
+			ft_mem_initialize();
 			options_initialize();
 			static pthread_once_t init_once = PTHREAD_ONCE_INIT;
 			pthread_once(&init_once, forksafe);
@@ -214,4 +221,7 @@
 
 	__attribute__((constructor)) static void malloc_initialize() { ensure_init(); }
 
+	// Events still in the trace buffers of the threads go to the trace file
+	__attribute__((destructor)) static void malloc_finalize() { if (g_manager.options.TRACING) trace_flush_all(); }
+
 #pragma endregion
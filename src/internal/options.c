@@ -66,6 +66,18 @@
 
 	#pragma endregion
 
+	#pragma region "ARENA_CPU"
+
+		static int validate_arena_cpu(int value) {
+			if (value < 0 || value > 1) return (0);
+
+			g_manager.options.ARENA_CPU = value;
+
+			return (1);
+		}
+
+	#pragma endregion
+
 	#pragma region "ARENA_MAX"
 
 		static int validate_arena_max(int value) {
@@ -78,6 +90,103 @@
 
 	#pragma endregion
 
+	#pragma region "HEAP_GROWTH"
+
+		static int validate_heap_growth(int value) {
+			if (value <= 0 || value > 8) return (0);
+
+			g_manager.options.HEAP_GROWTH = value;
+
+			return (1);
+		}
+
+	#pragma endregion
+
+	#pragma region "HEAP_MAX"
+
+		static int validate_heap_max(int value) {
+			if (value <= 0 || value > 16) return (0);
+
+			g_manager.options.HEAP_MAX = value;
+
+			return (1);
+		}
+
+	#pragma endregion
+
+	#pragma region "RETAIN_MAX"
+
+		static int validate_retain_max(int value) {
+			if (value < 0 || value > 1024) return (0);
+
+			g_manager.options.RETAIN_MAX = value;
+
+			return (1);
+		}
+
+	#pragma endregion
+
+	#pragma region "RETAIN_DECAY"
+
+		static int validate_retain_decay(int value) {
+			if (value < 0 || value > 3600000) return (0);
+
+			g_manager.options.RETAIN_DECAY = value;
+
+			return (1);
+		}
+
+	#pragma endregion
+
+	#pragma region "HUGE_PAGES"
+
+		static int validate_huge_pages(int value) {
+			if (value < 0 || value > 2) return (0);
+
+			g_manager.options.HUGE_PAGES = value;
+
+			return (1);
+		}
+
+	#pragma endregion
+
+	#pragma region "MMAP_THRESHOLD"
+
+		static int validate_mmap_threshold(int value) {
+			if (value < SMALL_CHUNK || value > MMAP_THRESHOLD_MAX) return (0);
+
+			g_manager.options.MMAP_THRESHOLD = value;
+			__atomic_store_n(&g_manager.mmap_threshold, (size_t)value, __ATOMIC_RELAXED);
+
+			return (1);
+		}
+
+	#pragma endregion
+
+	#pragma region "LATENCY"
+
+		static int validate_latency(int value) {
+			if (value < 0 || value > 1000000) return (0);
+
+			g_manager.options.LATENCY = value;
+
+			return (1);
+		}
+
+	#pragma endregion
+
+	#pragma region "PROFILE"
+
+		static int validate_profile(int value) {
+			if (value < 0 || value > 1073741824) return (0);
+
+			g_manager.options.PROFILE = value;
+
+			return (1);
+		}
+
+	#pragma endregion
+
 	#pragma region "DEBUG"
 
 		static int validate_debug(int value) {
@@ -102,42 +211,49 @@
 
 	#pragma endregion
 
-	#pragma region "LOGFILE"
+	#pragma region "Path"
 
-		static int validate_logfile(char *value) {
+		static void validate_path(char *path, char *value, char *extension) {
 			if (!value || !*value) value = "auto";
 
-			char pid_str[21] = {0};
+			char pid_str[32] = {0};
 			pid_t pid = getpid();
 
 			pid_str[0] = '_';
 			ft_itoa_buffered(pid, pid_str + 1, sizeof(pid_str) - 1);
-			ft_strlcat(pid_str, ".log", sizeof(pid_str));
+			ft_strlcat(pid_str, extension, sizeof(pid_str));
 
 			size_t value_len = ft_strlen(value);
 
 			if (!ft_strcmp(value, "auto")) {
-				ft_strlcpy(g_manager.options.LOGFILE, "/tmp/malloc", PATH_MAX);
-				ft_strlcat(g_manager.options.LOGFILE, pid_str, PATH_MAX);
+				ft_strlcpy(path, "/tmp/malloc", PATH_MAX);
+				ft_strlcat(path, pid_str, PATH_MAX);
 			} else if (ft_strchr(value, '/')) {
-				ft_strlcpy(g_manager.options.LOGFILE, value, PATH_MAX);
+				ft_strlcpy(path, value, PATH_MAX);
 				if (value[value_len - 1] == '/') {
-					ft_strlcat(g_manager.options.LOGFILE, "malloc", PATH_MAX);
-					ft_strlcat(g_manager.options.LOGFILE, pid_str, PATH_MAX);
+					ft_strlcat(path, "malloc", PATH_MAX);
+					ft_strlcat(path, pid_str, PATH_MAX);
 				}
 			} else {
-				if (!getcwd(g_manager.options.LOGFILE, PATH_MAX))
-					ft_strlcpy(g_manager.options.LOGFILE, "/tmp", PATH_MAX);
-				ft_strlcat(g_manager.options.LOGFILE, "/", PATH_MAX);
-				ft_strlcat(g_manager.options.LOGFILE, value, PATH_MAX);
-				ft_strlcat(g_manager.options.LOGFILE, pid_str, PATH_MAX);
+				if (!getcwd(path, PATH_MAX))
+					ft_strlcpy(path, "/tmp", PATH_MAX);
+				ft_strlcat(path, "/", PATH_MAX);
+				ft_strlcat(path, value, PATH_MAX);
+				ft_strlcat(path, pid_str, PATH_MAX);
 			}
+		}
+
+	#pragma endregion
+
+	#pragma region "LOGFILE"
+
+		static int validate_logfile(char *value) {
+			validate_path(g_manager.options.LOGFILE, value, ".log");
 
 			g_manager.options.fd_out = open(g_manager.options.LOGFILE, O_CREAT | O_WRONLY | O_TRUNC, 0644);
 			if (g_manager.options.fd_out == -1) {
 				if (print_log(1)) aprintf(2, 1, "\t\t  [ERROR] Unable to create log, falling back to default location '/tmp/malloc_[PID].log'\n");
-				ft_strlcpy(g_manager.options.LOGFILE, "/tmp/malloc", PATH_MAX);
-				ft_strlcat(g_manager.options.LOGFILE, pid_str, PATH_MAX);
+				validate_path(g_manager.options.LOGFILE, "auto", ".log");
 				g_manager.options.fd_out = open(g_manager.options.LOGFILE, O_CREAT | O_WRONLY | O_TRUNC, 0644);
 			}
 
@@ -146,6 +262,48 @@
 
 	#pragma endregion
 
+	#pragma region "TRACEFILE"
+
+		static int validate_tracefile(char *value) {
+			validate_path(g_manager.options.TRACEFILE, value, ".trace");
+
+			// Each flush is a single write() at the end of the file, so blocks of several threads do not overlap
+			g_manager.options.fd_trace = open(g_manager.options.TRACEFILE, O_CREAT | O_WRONLY | O_TRUNC | O_APPEND, 0644);
+			if (g_manager.options.fd_trace == -1) {
+				if (print_log(1)) aprintf(2, 1, "\t\t  [ERROR] Unable to create trace, falling back to default location '/tmp/malloc_[PID].trace'\n");
+				validate_path(g_manager.options.TRACEFILE, "auto", ".trace");
+				g_manager.options.fd_trace = open(g_manager.options.TRACEFILE, O_CREAT | O_WRONLY | O_TRUNC | O_APPEND, 0644);
+			}
+			if (g_manager.options.fd_trace == -1) return (0);
+
+			t_trace_header header = { .version = TRACE_VERSION, .event_size = sizeof(t_trace_event) };
+			ft_memcpy(header.magic, TRACE_MAGIC, sizeof(header.magic));
+			if (write(g_manager.options.fd_trace, &header, sizeof(header)) != sizeof(header)) return (0);
+
+			return (1);
+		}
+
+	#pragma endregion
+
+	#pragma region "TRACING"
+
+		static int validate_tracing(int value) {
+			if (value < 0 || value > 1) return (0);
+
+			// The trace file is created once (MALLOC_TRACEFILE or /tmp/malloc_[PID].trace)
+			if (value && g_manager.options.fd_trace == -1 && !validate_tracefile(getenv("MALLOC_TRACEFILE"))) {
+				if (g_manager.options.fd_trace != -1) close(g_manager.options.fd_trace);
+				g_manager.options.fd_trace = -1;
+				return (0);
+			}
+
+			g_manager.options.TRACING = value;
+
+			return (1);
+		}
+
+	#pragma endregion
+
 #pragma endregion
 
 #pragma region "Initialize"
@@ -175,6 +333,49 @@
 		if (var && ft_isdigit_s(var))	validate_arena_max(ft_atoi(var));
 		else							g_manager.options.ARENA_MAX = 0;
 
+		var = getenv("MALLOC_ARENA_CPU");
+		if (!var || !ft_isdigit_s(var) || !validate_arena_cpu(ft_atoi(var)))
+										g_manager.options.ARENA_CPU = 0;
+
+		var = getenv("MALLOC_HEAP_GROWTH");
+		if (!var || !ft_isdigit_s(var) || !validate_heap_growth(ft_atoi(var)))
+										g_manager.options.HEAP_GROWTH = 2;
+
+		var = getenv("MALLOC_HEAP_MAX");
+		if (!var || !ft_isdigit_s(var) || !validate_heap_max(ft_atoi(var)))
+										g_manager.options.HEAP_MAX = 4;
+
+		var = getenv("MALLOC_RETAIN_MAX");
+		if (!var || !ft_isdigit_s(var) || !validate_retain_max(ft_atoi(var)))
+										g_manager.options.RETAIN_MAX = 8;
+
+		var = getenv("MALLOC_RETAIN_DECAY");
+		if (!var || !ft_isdigit_s(var) || !validate_retain_decay(ft_atoi(var)))
+										g_manager.options.RETAIN_DECAY = 10000;
+
+		var = getenv("MALLOC_HUGE_PAGES");
+		if (!var || !ft_isdigit_s(var) || !validate_huge_pages(ft_atoi(var)))
+										g_manager.options.HUGE_PAGES = 0;
+
+		var = getenv("MALLOC_MMAP_THRESHOLD_");
+		if (!var || !ft_isdigit_s(var) || !validate_mmap_threshold(ft_atoi(var))) {
+										g_manager.options.MMAP_THRESHOLD = -1;
+										g_manager.mmap_threshold = MEDIUM_CHUNK;
+		}
+
+		var = getenv("MALLOC_LATENCY");
+		if (!var || !ft_isdigit_s(var) || !validate_latency(ft_atoi(var)))
+										g_manager.options.LATENCY = 0;
+
+		g_manager.options.fd_trace = -1;
+		var = getenv("MALLOC_TRACING");
+		if (!var || !ft_isdigit_s(var) || !validate_tracing(ft_atoi(var)))
+										g_manager.options.TRACING = 0;
+
+		var = getenv("MALLOC_PROFILE");
+		if (!var || !ft_isdigit_s(var) || !validate_profile(ft_atoi(var)))
+										g_manager.options.PROFILE = 0;
+
 		var = getenv("MALLOC_DEBUG");
 		if (var && ft_isdigit_s(var))	validate_debug(ft_atoi(var));
 		else							g_manager.options.DEBUG = 0;
@@ -202,6 +403,7 @@
 			if (g_manager.arena_count) {
 				if (print_log(0)) aprintf(g_manager.options.fd_out, 1, "\t[MALLOPT] Changes are not allowed after the first allocation\n");
 				errno = EINVAL;
+				mutex(&g_manager.mutex, MTX_UNLOCK);
 				return (0);
 			}
 
@@ -214,6 +416,16 @@
 			case M_PERTURB:			result = validate_perturb(value);		break;
 			case M_ARENA_TEST:		result = validate_arena_test(value);	break;
 			case M_ARENA_MAX:		result = validate_arena_max(value);		break;
+			case M_ARENA_CPU:		result = validate_arena_cpu(value);		break;
+			case M_HEAP_GROWTH:		result = validate_heap_growth(value);	break;
+			case M_HEAP_MAX:		result = validate_heap_max(value);		break;
+			case M_RETAIN_MAX:		result = validate_retain_max(value);	break;
+			case M_RETAIN_DECAY:	result = validate_retain_decay(value);	break;
+			case M_MMAP_THRESHOLD:	result = validate_mmap_threshold(value);	break;
+			case M_HUGE_PAGES:		result = validate_huge_pages(value);	break;
+			case M_LATENCY:			result = validate_latency(value);		break;
+			case M_TRACING:			result = validate_tracing(value);		break;
+			case M_PROFILE:			result = validate_profile(value);		break;
 			case M_DEBUG:			result = validate_debug(value);			break;
 			case M_LOGGING:			result = validate_logging(value);		break;
 		}
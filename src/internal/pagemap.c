@@ -0,0 +1,91 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   pagemap.c                                          :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vzurera- <vzurera-@student.42malaga.com    +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 11:02:31 by vzurera-          #+#    #+#             */
+/*   Updated: 2026/10/17 11:02:31 by vzurera-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#pragma region "Includes"
+
+	#include "internal.h"
+
+#pragma endregion
+
+#pragma region "Node"
+
+	static void *pagemap_node(void **slot) {
+		void *node = __atomic_load_n(slot, __ATOMIC_ACQUIRE);
+		if (node) return (node);
+
+		void *new_node = internal_alloc(PAGEMAP_SIZE * sizeof(void *));
+		if (!new_node) return (NULL);
+
+		if (!__atomic_compare_exchange_n(slot, &node, new_node, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+			internal_free(new_node, PAGEMAP_SIZE * sizeof(void *));
+			return (node);
+		}
+
+		return (new_node);
+	}
+
+#pragma endregion
+
+#pragma region "Set"
+
+	int pagemap_set(void *ptr, size_t size, t_heap *heap) {
+		if (!ptr || !size) return (1);
+
+		uintptr_t first = (uintptr_t)ptr >> PAGEMAP_SHIFT;
+		uintptr_t last = ((uintptr_t)ptr + size - 1) >> PAGEMAP_SHIFT;
+		if ((last >> (PAGEMAP_BITS * 2)) >= PAGEMAP_ROOT) return (1);
+
+		for (uintptr_t page = first; page <= last; ++page) {
+			void **middle = pagemap_node((void **)&g_manager.pagemap[page >> (PAGEMAP_BITS * 2)]);
+			if (!middle) return (1);
+
+			t_heap **leaf = pagemap_node(&middle[(page >> PAGEMAP_BITS) & (PAGEMAP_SIZE - 1)]);
+			if (!leaf) return (1);
+
+			__atomic_store_n(&leaf[page & (PAGEMAP_SIZE - 1)], heap, __ATOMIC_RELEASE);
+		}
+
+		return (0);
+	}
+
+#pragma endregion
+
+#pragma region "Get"
+
+	t_heap *pagemap_get(void *ptr) {
+		uintptr_t page = (uintptr_t)ptr >> PAGEMAP_SHIFT;
+		if ((page >> (PAGEMAP_BITS * 2)) >= PAGEMAP_ROOT) return (NULL);
+
+		void **middle = __atomic_load_n(&g_manager.pagemap[page >> (PAGEMAP_BITS * 2)], __ATOMIC_ACQUIRE);
+		if (!middle) return (NULL);
+
+		t_heap **leaf = __atomic_load_n(&middle[(page >> PAGEMAP_BITS) & (PAGEMAP_SIZE - 1)], __ATOMIC_ACQUIRE);
+		if (!leaf) return (NULL);
+
+		return (__atomic_load_n(&leaf[page & (PAGEMAP_SIZE - 1)], __ATOMIC_ACQUIRE));
+	}
+
+#pragma endregion
+
+#pragma region "Information"
+
+	// Radix tree that maps every page of every heap to its t_heap.
+	//
+	//   • Three levels (root, middle and leaf) indexed by the bits of the page number.
+	//   • Nodes are created on demand and never released, so readers don't need any lock.
+	//   • heap_create() writes the entries of the new mapping and a heap can be found from any pointer inside it.
+	//
+	// Notes:
+	//   • Entries of destroyed heaps are kept (the heap info is inactive) until the address range is reused by another heap.
+	//     That is how a free of an unmapped pointer is still reported as an error.
+
+#pragma endregion
@@ -0,0 +1,184 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   trace.c                                            :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vzurera- <vzurera-@student.42malaga.com    +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 21:14:52 by vzurera-          #+#    #+#             */
+/*   Updated: 2026/10/17 21:14:52 by vzurera-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#pragma region "Includes"
+
+	#include "arena.h"
+
+	#include <sys/syscall.h>
+
+#pragma endregion
+
+#pragma region "Write"
+
+	static void trace_write(t_trace_event *events, size_t count) {
+		char	*data = (char *)events;
+		size_t	size = count * sizeof(t_trace_event);
+
+		while (size) {
+			ssize_t written = write(g_manager.options.fd_trace, data, size);
+			if (written < 0 && errno == EINTR) continue;
+			if (written <= 0) {
+				if (print_log(1)) aprintf(g_manager.options.fd_out, 1, "\t\t  [ERROR] Unable to write trace\n");
+				return ;
+			}
+
+			data += written;
+			size -= written;
+		}
+	}
+
+#pragma endregion
+
+#pragma region "Flush"
+
+	static void trace_flush(t_trace *trace) {
+		int expected = 0;
+
+		if (!trace || !__atomic_compare_exchange_n(&trace->flushing, &expected, 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) return ;
+
+		int		saved_errno = errno;
+		size_t	head = __atomic_load_n(&trace->head, __ATOMIC_ACQUIRE);
+		size_t	tail = trace->tail;
+
+		// Pending events wrap around the end of the buffer at most once (two blocks)
+		while (tail < head) {
+			size_t index = tail % TRACE_EVENTS;
+			size_t count = TRACE_EVENTS - index;
+
+			if (count > head - tail) count = head - tail;
+			trace_write(&trace->events[index], count);
+			tail += count;
+		}
+
+		__atomic_store_n(&trace->tail, tail, __ATOMIC_RELEASE);
+		__atomic_store_n(&trace->flushing, 0, __ATOMIC_RELEASE);
+		errno = saved_errno;
+	}
+
+	void trace_flush_all() {
+		for (t_trace *trace = __atomic_load_n(&g_manager.trace, __ATOMIC_ACQUIRE); trace; trace = trace->next)
+			trace_flush(trace);
+	}
+
+#pragma endregion
+
+#pragma region "Get"
+
+	static t_trace *trace_get() {
+		t_trace *trace = __atomic_load_n(&g_manager.trace, __ATOMIC_ACQUIRE);
+
+		// A buffer released by an exited thread is reused (no lock, events can come from any allocator path)
+		for (; trace; trace = trace->next) {
+			int expected = 0;
+			if (__atomic_compare_exchange_n(&trace->used, &expected, 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) break;
+		}
+
+		if (!trace) {
+			if (!(trace = internal_alloc(sizeof(t_trace)))) return (NULL);
+			trace->used = 1;
+			trace->next = __atomic_load_n(&g_manager.trace, __ATOMIC_RELAXED);
+			while (!__atomic_compare_exchange_n(&g_manager.trace, &trace->next, trace, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED)) ;
+		}
+
+		trace->thread = (uint32_t)syscall(SYS_gettid);
+		return (trace);
+	}
+
+#pragma endregion
+
+#pragma region "Source"
+
+	char *trace_name(int source) {
+		static char *sources[] = TRACE_SOURCES;
+
+		if (source < 0 || source >= (int)(sizeof(sources) / sizeof(*sources))) source = SRC_UNKNOWN;
+		return (sources[source]);
+	}
+
+#pragma endregion
+
+#pragma region "Event"
+
+	void trace_event(int op, void *ptr, size_t size, int info) {
+		t_trace *trace = thread_cache.trace;
+
+		if (!trace && !(trace = thread_cache.trace = trace_get())) return ;
+
+		// Full: the owner writes the whole buffer to the file (or waits for the thread that is already doing it)
+		while (trace->head - __atomic_load_n(&trace->tail, __ATOMIC_ACQUIRE) >= TRACE_EVENTS) trace_flush(trace);
+
+		t_trace_event *event = &trace->events[trace->head % TRACE_EVENTS];
+		event->tsc = latency_ticks();
+		event->ptr = (uintptr_t)ptr;
+		if (op == TRACE_HEAP_CREATE || op == TRACE_HEAP_FREE) event->heap = (uintptr_t)ptr;
+		else {
+			t_heap *heap = pagemap_get(ptr);
+			event->heap = (heap) ? (uintptr_t)heap->ptr : 0;
+		}
+		event->size = size;
+		event->thread = trace->thread;
+		event->arena = (tcache) ? tcache->id : 0;
+		event->op = op;
+		event->info = info;
+
+		__atomic_store_n(&trace->head, trace->head + 1, __ATOMIC_RELEASE);
+	}
+
+#pragma endregion
+
+#pragma region "Release"
+
+	void trace_release() {
+		t_trace *trace = thread_cache.trace;
+
+		if (!trace) return ;
+
+		trace_flush(trace);
+		thread_cache.trace = NULL;
+		__atomic_store_n(&trace->used, 0, __ATOMIC_RELEASE);
+	}
+
+#pragma endregion
+
+#pragma region "Fork"
+
+	void trace_fork() {
+		// Pending events of the parent are written by the parent (only the thread that called fork() exists in the child)
+		for (t_trace *trace = g_manager.trace; trace; trace = trace->next) {
+			trace->tail = trace->head;
+			trace->flushing = 0;
+			trace->used = (trace == thread_cache.trace);
+		}
+
+		if (thread_cache.trace) thread_cache.trace->thread = (uint32_t)syscall(SYS_gettid);
+	}
+
+#pragma endregion
+
+#pragma region "Information"
+
+	// Binary trace of allocations and frees (MALLOC_TRACING / M_TRACING).
+	//
+	//   • Each event is a fixed-size record (t_trace_event): tsc, pointer, heap, size, thread, arena, event and function.
+	//   • Events go to a ring buffer of the thread, without locks and without formatting any text.
+	//   • A full buffer is written to the trace file with one write() (O_APPEND, so blocks of several threads do not overlap).
+	//   • Buffers are also written when their thread exits and when the process exits.
+	//
+	// Notes:
+	//   • The file starts with a t_trace_header (magic, version and size of each event).
+	//   • tester/tests/trace_decode.c sorts the events by tsc and prints them with the format of the log.
+	//   • Buffers are created on the first event of a thread, and reused by new threads when a thread exits.
+	//   • Events still in the buffers are lost if the process ends without running its destructors (_exit, abort, signals).
+	//   • Errors are still reported as text (MALLOC_DEBUG / MALLOC_LOGGING).
+
+#pragma endregion
@@ -0,0 +1,111 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   alloc_latency.c                                    :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vzurera- <vzurera-@student.42malaga.com    +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 20:31:07 by vzurera-          #+#    #+#             */
+/*   Updated: 2026/10/17 20:31:07 by vzurera-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#pragma region "Includes"
+
+	#include "arena.h"
+
+#pragma endregion
+
+#pragma region "Percentile"
+
+	static size_t bucket_ns(int bucket, double scale) {
+		size_t ns = (size_t)((double)((uint64_t)1 << bucket) * scale + 0.5);
+
+		return ((ns) ? ns : 1);
+	}
+
+	static int percentile(uint32_t *counts, size_t total, size_t per_mille) {
+		size_t	target = ((total * per_mille) + 999) / 1000;
+		size_t	sum = 0;
+		int		bucket = 0;
+
+		for (; bucket < LATENCY_BUCKETS - 1; ++bucket)
+			if ((sum += counts[bucket]) >= target) break;
+
+		return (bucket);
+	}
+
+#pragma endregion
+
+#pragma region "Print"
+
+	static void print_histogram(uint32_t *counts, int op, int type, int path, double scale) {
+		const char	*ops[] = { "malloc", "free", "realloc" };
+		const char	*types[] = { "TINY", "SMALL", "MEDIUM", "LARGE" };
+		const char	*paths[] = { "cache", "bin", "top", "heap", "mmap" };
+		size_t		total = 0;
+		int			max = 0;
+
+		for (int i = 0; i < LATENCY_BUCKETS; ++i) {
+			total += counts[i];
+			if (counts[i]) max = i;
+		}
+		if (!total) return ;
+
+		aprintf(2, 0, " • %s\t%s\t%s\t%u samples\tp50 < %u ns\tp99 < %u ns\tp99.9 < %u ns\tmax < %u ns\n", ops[op], types[type], paths[path], total,
+			bucket_ns(percentile(counts, total, 500), scale), bucket_ns(percentile(counts, total, 990), scale),
+			bucket_ns(percentile(counts, total, 999), scale), bucket_ns(max, scale));
+
+		aprintf(2, 0, "  ");
+		for (int i = 0; i <= max; ++i)
+			if (counts[i]) aprintf(2, 0, " < %u ns: %u ", bucket_ns(i, scale), counts[i]);
+		aprintf(2, 0, "\n");
+	}
+
+#pragma endregion
+
+#pragma region "Show Alloc Latency"
+
+	__attribute__((visibility("default")))
+	void show_alloc_latency() {
+		ensure_init();
+
+		t_latency	total;
+		int			threads = latency_total(&total);
+		double		scale = latency_scale();
+
+		aprintf(2, 0, "———————————————————————————————————————————————————————————————\n");
+		if (!g_manager.options.LATENCY)	aprintf(2, 0, " • Latency sampling disabled (MALLOC_LATENCY)\n");
+		else							aprintf(2, 0, " • Latency of 1 in %d calls across %d thread%s\n", g_manager.options.LATENCY, threads, threads == 1 ? "" : "s");
+		aprintf(2, 0, "———————————————————————————————————————————————————————————————\n");
+
+		for (int op = 0; op < LATENCY_OPS; ++op)
+			for (int type = TINY; type <= LARGE; ++type)
+				for (int path = 0; path < LATENCY_PATHS; ++path)
+					print_histogram(total.counts[op][type][path], op, type, path, scale);
+	}
+
+#pragma endregion
+
+#pragma region "Information"
+
+	// Prints the latency histograms of malloc(), free() and realloc() (enabled with MALLOC_LATENCY or M_LATENCY).
+	//
+	//   void show_alloc_latency(void);
+	//
+	//   • One line per operation, heap type and internal path with samples: count, p50, p99, p99.9 and max.
+	//   • Below it, the number of samples of each bucket.
+	//
+	// Paths:
+	//   • cache:  served by the thread cache (no lock).
+	//   • bin:    a free chunk of a bin or a slab with free objects (free: given back to its heap).
+	//   • top:    split of a top chunk or a new slab (realloc: resized in place).
+	//   • heap:   a new heap was created (free: a heap was destroyed).
+	//   • mmap:   LARGE block mapped (free: unmapped, realloc: remapped).
+	//
+	// Notes:
+	//   • Output is written to file descriptor 2 (stderr).
+	//   • Latencies are the upper bound of their bucket (powers of two), so they are accurate to a factor of 2.
+	//   • Histograms of exited threads are kept.
+
+#pragma endregion
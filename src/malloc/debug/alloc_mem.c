@@ -20,7 +20,7 @@
 
 	#pragma region "Count Heaps"
 
-		static void count_heaps(t_heap_header *heap_header, int *heaps_count, int *tiny_count, int *small_count, int *large_count) {
+		static void count_heaps(t_heap_header *heap_header, int *heaps_count, int *tiny_count, int *small_count, int *medium_count, int *large_count) {
 			if (!heap_header) return ;
 
 			while (heap_header) {
@@ -31,6 +31,7 @@
 						(*heaps_count)++;
 						if (heap->type == TINY) (*tiny_count)++;
 						if (heap->type == SMALL) (*small_count)++;
+						if (heap->type == MEDIUM) (*medium_count)++;
 						if (heap->type == LARGE) (*large_count)++;
 					}
 					heap = (t_heap *)((char *)heap + ALIGN(sizeof(t_heap)));
@@ -133,17 +134,45 @@
 
 	#pragma endregion
 
+	#pragma region "Print Slabs"
+
+		static size_t print_slabs(t_heap *heap) {
+			size_t total = 0;
+
+			for (char *page = heap->ptr; page < (char *)heap->top_chunk; page += SLAB_SIZE) {
+				t_slab *slab = (t_slab *)page;
+				if (!slab->size) continue;
+
+				for (int i = 0; i < slab->count; ++i) {
+					char *ptr = SLAB_START(slab) + (i * slab->size);
+					if ((slab->map[i / 64] & ((uint64_t)1 << (i % 64))) || SLAB_CACHED(ptr)) continue;
+
+					write(2, " ", 1);
+					print_hex8(ptr);
+					write(2, " - ", 3);
+					print_hex8(ptr + slab->size - 1);
+					aprintf(2, 0, " : %u bytes\n", slab->size);
+					total += slab->size;
+				}
+			}
+
+			return (total);
+		}
+
+	#pragma endregion
+
 	#pragma region "Print Heap"
 
 		static size_t print_heap(t_heap *heap) {
 			if (!heap) return (0);
+			if (heap->type == TINY) return (print_slabs(heap));
 
 			t_chunk	*chunk = heap->ptr;
 			size_t	total = 0;
 
 			while (chunk) {
 				if (IS_TOPCHUNK(chunk) && heap->type != LARGE) break;
-				if (heap->type == LARGE || !IS_FREE(chunk)) {
+				if (heap->type == LARGE || (!IS_FREE(chunk) && !HAS_POISON(GET_PTR(chunk)))) {
 					write(2, " ", 1);
 					print_hex8(GET_PTR(chunk));
 					write(2, " - ", 3);
@@ -162,7 +191,7 @@
 
 	#pragma region "Print Heaps"
 
-		static size_t print_heaps(t_arena *arena, t_heap **heaps, int heaps_count, int tiny_count, int small_count, int large_count) {
+		static size_t print_heaps(t_arena *arena, t_heap **heaps, int heaps_count, int tiny_count, int small_count, int medium_count, int large_count) {
 			if (!arena || !heaps) return (0);
 
 			aprintf(2, 0, "————————————\n");
@@ -170,7 +199,8 @@
 			aprintf(2, 0, "—————————————————————————————————————————\n");
 			aprintf(2, 0, " • Allocations: %u\t• Frees: %u\n", arena->alloc_count, arena->free_count);
 			aprintf(2, 0, " • TINY: %u \t\t• SMALL: %u\n", tiny_count, small_count);
-			aprintf(2, 0, " • LARGE: %u\t\t• TOTAL: %u\n", large_count, heaps_count);
+			aprintf(2, 0, " • MEDIUM: %u\t\t• LARGE: %u\n", medium_count, large_count);
+			aprintf(2, 0, " • TOTAL: %u\n", heaps_count);
 			aprintf(2, 0, "—————————————————————————————————————————\n\n");
 
 			size_t arena_total = 0;
@@ -181,6 +211,7 @@
 				char *type;
 				if (heaps[i]->type == TINY) type = "TINY ";
 				if (heaps[i]->type == SMALL) type = "SMALL";
+				if (heaps[i]->type == MEDIUM) type = "MEDIUM";
 				if (heaps[i]->type == LARGE) type = "LARGE";
 				
 				if (i > 0) aprintf(2, 0, "\n");
@@ -214,46 +245,45 @@
 
 	__attribute__((visibility("default")))
 	void show_alloc_mem() {
-	
-		mutex(&g_manager.mutex, MTX_LOCK);
-
-			t_arena *arena = &g_manager.arena;
-			size_t	total = 0;
-			int alloc_count = 0;
-			int free_count = 0;
-
-			for (int i = 0; i < g_manager.arena_count; ++i) {
-				if (!arena) break;
-				int heaps_count = 0;
-				int tiny_count = 0;
-				int small_count = 0;
-				int large_count = 0;
-
-				mutex(&arena->mutex, MTX_LOCK);
-
-					alloc_count += arena->alloc_count;
-					free_count += arena->free_count;
-					count_heaps(arena->heap_header, &heaps_count, &tiny_count, &small_count, &large_count);
-					if (heaps_count) {
-						t_heap *heaps[heaps_count + 1];
-						ft_memset(heaps, 0, sizeof(heaps));
-						load_heaps(arena->heap_header, heaps, heaps_count);
-						sort_heaps(heaps);
-						total += print_heaps(arena, heaps, heaps_count, tiny_count, small_count, large_count);
-					}
-
-				mutex(&arena->mutex, MTX_UNLOCK);
-				arena = arena->next;
-			}
+		t_arena *arena = &g_manager.arena;
+		size_t	total = 0;
+		int alloc_count = 0;
+		int free_count = 0;
+		int arena_count = __atomic_load_n(&g_manager.arena_count, __ATOMIC_ACQUIRE);
+
+		for (int i = 0; i < arena_count; ++i) {
+			if (!arena) break;
+			int heaps_count = 0;
+			int tiny_count = 0;
+			int small_count = 0;
+			int medium_count = 0;
+			int large_count = 0;
+
+			mutex(&arena->mutex, MTX_LOCK);
+
+				if (arena == tcache) cache_sync(arena);
+				remote_drain(arena);
+				alloc_count += arena->alloc_count;
+				free_count += arena->free_count;
+				count_heaps(arena->heap_header, &heaps_count, &tiny_count, &small_count, &medium_count, &large_count);
+				if (heaps_count) {
+					t_heap *heaps[heaps_count + 1];
+					ft_memset(heaps, 0, sizeof(heaps));
+					load_heaps(arena->heap_header, heaps, heaps_count);
+					sort_heaps(heaps);
+					total += print_heaps(arena, heaps, heaps_count, tiny_count, small_count, medium_count, large_count);
+				}
 
-			
-			if (!total) aprintf(2, 0, "No memory has been allocated\n");
-			else if (g_manager.arena_count > 0) {
-				aprintf(2, 0, "———————————————————————————————————————————————————————————————\n");
-				aprintf(2, 0, " • %d allocation%s, %d free%s and %u byte%s across %d arena%s\n", alloc_count, alloc_count == 1 ? "" : "s", free_count, free_count == 1 ? "" : "s", total, total == 1 ? "" : "s", g_manager.arena_count, g_manager.arena_count == 1 ? "" : "s");
-			}
+			mutex(&arena->mutex, MTX_UNLOCK);
+			arena = __atomic_load_n(&arena->next, __ATOMIC_ACQUIRE);
+		}
 
-		mutex(&g_manager.mutex, MTX_UNLOCK);
+		
+		if (!total) aprintf(2, 0, "No memory has been allocated\n");
+		else if (arena_count > 0) {
+			aprintf(2, 0, "———————————————————————————————————————————————————————————————\n");
+			aprintf(2, 0, " • %d allocation%s, %d free%s and %u byte%s across %d arena%s\n", alloc_count, alloc_count == 1 ? "" : "s", free_count, free_count == 1 ? "" : "s", total, total == 1 ? "" : "s", arena_count, arena_count == 1 ? "" : "s");
+		}
 	}
 
 #pragma endregion
@@ -55,7 +55,7 @@
 		if (!arena || !ptr || !heap) return ;
 
 		t_chunk *chunk = GET_HEAD(ptr);
-		size_t	chunk_size = GET_SIZE(chunk);
+		size_t	chunk_size = (heap->type == TINY) ? GET_SLAB(ptr)->size : GET_SIZE(chunk);
 
 		if (offset >= chunk_size) { aprintf(2, 0, "Invalid offset, the maximum offset for this pointer is %u bytes\n", chunk_size - 1);	return ; }
 
@@ -67,8 +67,10 @@
 		aprintf(2, 0, "————————————————————————————————————————————————————————————————————————————————————\n");
 		aprintf(2, 0, " • Size: %u bytes      • Offset: %u bytes      • Length: %u bytes%s\n", chunk_size, offset, size, remaining < length ? " (truncated)" : "");
 		aprintf(2, 0, "————————————————————————————————————————————————————————————————————————————————————\n");
-		print_hex((char *)chunk, sizeof(t_chunk));
-		aprintf(2, 0, "————————————————————————————————————————————————————————————————————————————————————\n");
+		if (heap->type != TINY) {
+			print_hex((char *)chunk, sizeof(t_chunk));
+			aprintf(2, 0, "————————————————————————————————————————————————————————————————————————————————————\n");
+		}
 		print_hex((char *)ptr + offset, size);
 		aprintf(2, 0, "————————————————————————————————————————————————————————————————————————————————————\n");
 	}
@@ -80,6 +82,12 @@
 	static int validate_ptr(t_arena *arena, void *ptr, t_heap *heap) {
 		if (!arena || !ptr || !heap) return (1);
 
+		// TINY (no header)
+		if (heap->type == TINY) {
+			if (slab_check(ptr, heap)) { aprintf(2, 0, "Pointer %p is not at the start of a chunk\n", ptr); return (1); }
+			return (0);
+		}
+
 		// LARGE
 		if (heap->type == LARGE) {
 			if (GET_HEAD(ptr) == heap->ptr) {
@@ -115,37 +123,26 @@
 
 		// malloc(0)
 		if (check_digit(ptr, ZERO_MALLOC_BASE)) {
-			mutex(&g_manager.mutex, MTX_LOCK);
-
-				if (ptr > ZERO_MALLOC_BASE && ptr < (void *)((char *)ZERO_MALLOC_BASE + (g_manager.alloc_zero_counter * ALIGNMENT)))
-					aprintf(2, 0, "Pointer %p is invalid\n", ptr);
+			if (ptr > ZERO_MALLOC_BASE && ptr < (void *)((char *)ZERO_MALLOC_BASE + (__atomic_load_n(&g_manager.alloc_zero_counter, __ATOMIC_RELAXED) * ALIGNMENT)))
+				aprintf(2, 0, "Pointer %p is invalid\n", ptr);
 
-			mutex(&g_manager.mutex, MTX_UNLOCK);
 			return ;
 		}
 
-		t_arena	*arena = &g_manager.arena;
-		t_heap	*heap = NULL;
+		t_heap *heap = pagemap_get(ptr);
 
-		mutex(&g_manager.mutex, MTX_LOCK);
+		if (heap && heap->active) {
+			t_arena *arena = heap->arena;
+			mutex(&arena->mutex, MTX_LOCK);
 
-			while (arena) {
-				mutex(&arena->mutex, MTX_LOCK);
+				if (heap->active) {
+					if (!validate_ptr(arena, ptr, heap)) show_ex(arena, ptr, heap, offset, length);
+					mutex(&arena->mutex, MTX_UNLOCK);
+					return ;
+				}
 
-					if ((heap = heap_find(arena, ptr))) {
-						if (heap->active) {
-							if (!validate_ptr(arena, ptr, heap)) show_ex(arena, ptr, heap, offset, length);
-							mutex(&arena->mutex, MTX_UNLOCK);
-							mutex(&g_manager.mutex, MTX_UNLOCK);
-							return ;
-						}
-					}
-
-				mutex(&arena->mutex, MTX_UNLOCK);
-				arena = arena->next;
-			}
-
-		mutex(&g_manager.mutex, MTX_UNLOCK);
+			mutex(&arena->mutex, MTX_UNLOCK);
+		}
 
 		aprintf(2, 0, "Pointer %p is not allocated\n", ptr); return ;
 	}
@@ -0,0 +1,61 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   mallinfo2.c                                        :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vzurera- <vzurera-@student.42malaga.com    +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 19:30:05 by vzurera-          #+#    #+#             */
+/*   Updated: 2026/10/17 19:30:05 by vzurera-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#pragma region "Includes"
+
+	#include "arena.h"
+
+#pragma endregion
+
+#pragma region "Mallinfo2"
+
+	__attribute__((visibility("default")))
+	struct mallinfo2 mallinfo2() {
+		ensure_init();
+
+		struct mallinfo2	info;
+		t_stats				total;
+		size_t				retained = 0;
+
+		ft_memset(&info, 0, sizeof(info));
+		stats_total(&total, &retained);
+
+		info.arena = total.mapped - total.large;
+		info.hblks = total.heaps[LARGE];
+		info.hblkhd = total.large;
+		info.uordblks = total.in_use;
+		info.fordblks = (total.mapped > total.in_use) ? total.mapped - total.in_use : 0;
+		info.keepcost = retained;
+
+		return (info);
+	}
+
+#pragma endregion
+
+#pragma region "Information"
+
+	// Returns the memory usage of the allocator, added up across all arenas.
+	//
+	//   struct mallinfo2 mallinfo2(void);
+	//
+	//   • arena    – bytes mapped for heaps and superblocks (not LARGE blocks, retained heaps included).
+	//   • hblks    – number of LARGE blocks (one mapping each).
+	//   • hblkhd   – bytes mapped for LARGE blocks.
+	//   • uordblks – bytes in use (usable size of the blocks handed out, including the ones in thread caches).
+	//   • fordblks – bytes mapped but not in use (headers, free chunks and retained heaps).
+	//   • keepcost – bytes of empty heaps kept mapped for reuse (given back to the system after MALLOC_RETAIN_DECAY).
+	//
+	// Notes:
+	//   • ordblks, smblks, usmblks and fsmblks are not tracked (always 0).
+	//   • The counters are read without locking, so it can be called often (each value is exact, but they are not a snapshot of the same instant).
+
+#pragma endregion
@@ -0,0 +1,114 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   malloc_info.c                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vzurera- <vzurera-@student.42malaga.com    +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 19:41:16 by vzurera-          #+#    #+#             */
+/*   Updated: 2026/10/17 19:41:16 by vzurera-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#pragma region "Includes"
+
+	#include "arena.h"
+
+	#include <errno.h>
+
+#pragma endregion
+
+#pragma region "Print"
+
+	#pragma region "Sizes"
+
+		static void print_sizes(int fd, t_stats *stats) {
+			aprintf(fd, 0, "<sizes>\n");
+
+			for (int i = 0; i < (int)STATS_CLASSES; ++i) {
+				if (!stats->allocs[i] && !stats->frees[i]) continue;
+
+				size_t from = (i) ? ((size_t)8 << i) + 1 : 1;
+				size_t to = (i < (int)STATS_CLASSES - 1) ? (size_t)16 << i : SIZE_MAX;
+				aprintf(fd, 0, "<size from=\"%u\" to=\"%u\" allocs=\"%u\" frees=\"%u\"/>\n", from, to, stats->allocs[i], stats->frees[i]);
+			}
+
+			aprintf(fd, 0, "</sizes>\n");
+		}
+
+	#pragma endregion
+
+	#pragma region "Totals"
+
+		static void print_totals(int fd, t_stats *stats, size_t retained) {
+			aprintf(fd, 0, "<heaps tiny=\"%u\" small=\"%u\" medium=\"%u\" large=\"%u\"/>\n", stats->heaps[TINY], stats->heaps[SMALL], stats->heaps[MEDIUM], stats->heaps[LARGE]);
+			aprintf(fd, 0, "<total type=\"mapped\" size=\"%u\"/>\n", stats->mapped);
+			aprintf(fd, 0, "<total type=\"large\" count=\"%u\" size=\"%u\"/>\n", stats->heaps[LARGE], stats->large);
+			aprintf(fd, 0, "<total type=\"in_use\" size=\"%u\"/>\n", stats->in_use);
+			aprintf(fd, 0, "<total type=\"retained\" size=\"%u\"/>\n", retained);
+		}
+
+	#pragma endregion
+
+#pragma endregion
+
+#pragma region "Malloc Info"
+
+	__attribute__((visibility("default")))
+	int malloc_info(int options, FILE *stream) {
+		ensure_init();
+
+		if (options || !stream) { errno = EINVAL; return (-1); }
+
+		// Written straight to the descriptor (whatever is buffered in the stream goes first)
+		int fd = fileno(stream);
+		if (fd < 0 || fflush(stream)) return (-1);
+
+		t_arena	*arena = &g_manager.arena;
+		int		arena_count = __atomic_load_n(&g_manager.arena_count, __ATOMIC_ACQUIRE);
+
+		aprintf(fd, 0, "<malloc version=\"1\">\n");
+
+		for (int i = 0; i < arena_count && arena; ++i) {
+			t_stats stats;
+
+			stats_load(arena, &stats);
+			aprintf(fd, 0, "<heap nr=\"%d\">\n", arena->id);
+			print_sizes(fd, &stats);
+			print_totals(fd, &stats, __atomic_load_n(&arena->retained, __ATOMIC_RELAXED));
+			aprintf(fd, 0, "</heap>\n");
+
+			arena = __atomic_load_n(&arena->next, __ATOMIC_ACQUIRE);
+		}
+
+		t_stats	total;
+		size_t	retained = 0;
+
+		stats_total(&total, &retained);
+		print_sizes(fd, &total);
+		print_totals(fd, &total, retained);
+		aprintf(fd, 0, "</malloc>\n");
+
+		return (0);
+	}
+
+#pragma endregion
+
+#pragma region "Information"
+
+	// Writes the memory usage of each arena and the total as XML.
+	//
+	//   int malloc_info(int options, FILE *stream);
+	//
+	//   options – must be 0.
+	//   stream  – where the XML is written.
+	//
+	//   • On success: returns 0.
+	//   • On failure: returns -1 (errno is set to EINVAL if options is not 0).
+	//
+	// Notes:
+	//   • <size> has the allocations and frees of each size class (powers of two, only the ones used).
+	//   • The layout follows the one of glibc (<malloc>, one <heap> per arena, then the totals).
+	//   • No arena is locked, so it does not stop other threads (see mallinfo2() for the meaning of each value).
+
+#pragma endregion
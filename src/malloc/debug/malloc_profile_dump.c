@@ -0,0 +1,109 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   malloc_profile_dump.c                              :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vzurera- <vzurera-@student.42malaga.com    +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 00:34:10 by vzurera-          #+#    #+#             */
+/*   Updated: 2026/10/18 00:34:10 by vzurera-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#pragma region "Includes"
+
+	#include "arena.h"
+
+#pragma endregion
+
+#pragma region "Print"
+
+	#pragma region "Stacks"
+
+		static void print_stacks(int fd, t_profile *profile) {
+			size_t live_count = 0, live_bytes = 0, total_count = 0, total_bytes = 0;
+
+			for (int i = 0; profile && i < PROFILE_STACKS; ++i) {
+				if (__atomic_load_n(&profile->stacks[i].hash, __ATOMIC_ACQUIRE) < 2) continue;
+				live_count += __atomic_load_n(&profile->stacks[i].live_count, __ATOMIC_RELAXED);
+				live_bytes += __atomic_load_n(&profile->stacks[i].live_bytes, __ATOMIC_RELAXED);
+				total_count += __atomic_load_n(&profile->stacks[i].total_count, __ATOMIC_RELAXED);
+				total_bytes += __atomic_load_n(&profile->stacks[i].total_bytes, __ATOMIC_RELAXED);
+			}
+
+			aprintf(fd, 0, "heap profile: %u: %u [%u: %u] @ heap_v2/%d\n", live_count, live_bytes, total_count, total_bytes, g_manager.options.PROFILE);
+
+			for (int i = 0; profile && i < PROFILE_STACKS; ++i) {
+				t_profile_stack *stack = &profile->stacks[i];
+
+				if (__atomic_load_n(&stack->hash, __ATOMIC_ACQUIRE) < 2) continue;
+
+				aprintf(fd, 0, "%u: %u [%u: %u] @", __atomic_load_n(&stack->live_count, __ATOMIC_RELAXED), __atomic_load_n(&stack->live_bytes, __ATOMIC_RELAXED),
+					__atomic_load_n(&stack->total_count, __ATOMIC_RELAXED), __atomic_load_n(&stack->total_bytes, __ATOMIC_RELAXED));
+				for (uint32_t j = 0; j < stack->depth; ++j) aprintf(fd, 0, " %p", stack->frames[j]);
+				aprintf(fd, 0, "\n");
+			}
+		}
+
+	#pragma endregion
+
+	#pragma region "Mappings"
+
+		// pprof maps the addresses to binaries and symbols with the mappings of the process
+		static void print_mappings(int fd) {
+			char	buffer[4096];
+			ssize_t	bytes;
+			int		maps = open("/proc/self/maps", O_RDONLY);
+
+			aprintf(fd, 0, "\nMAPPED_LIBRARIES:\n");
+			if (maps == -1) return ;
+
+			while ((bytes = read(maps, buffer, sizeof(buffer))) > 0)
+				if (write(fd, buffer, bytes) != bytes) break;
+
+			close(maps);
+		}
+
+	#pragma endregion
+
+#pragma endregion
+
+#pragma region "Malloc Profile Dump"
+
+	__attribute__((visibility("default")))
+	int malloc_profile_dump(const char *path) {
+		ensure_init();
+
+		if (!path || !g_manager.options.PROFILE) { errno = EINVAL; return (-1); }
+
+		int fd = open(path, O_CREAT | O_WRONLY | O_TRUNC, 0644);
+		if (fd == -1) return (-1);
+
+		print_stacks(fd, __atomic_load_n(&g_manager.profile, __ATOMIC_ACQUIRE));
+		print_mappings(fd);
+		close(fd);
+
+		return (0);
+	}
+
+#pragma endregion
+
+#pragma region "Information"
+
+	// Writes the samples of the heap profiler as a heap profile of pprof.
+	//
+	//   int malloc_profile_dump(const char *path);
+	//
+	//   path – file where the profile is written (created or truncated).
+	//
+	//   • On success: returns 0.
+	//   • On failure: returns -1 and sets errno (EINVAL if path is NULL or MALLOC_PROFILE is disabled).
+	//
+	// Notes:
+	//   • Legacy text format of gperftools (heap_v2), read by pprof: one line per call stack with the live samples
+	//     and bytes, the samples and bytes since the start in brackets, and the return addresses.
+	//   • Counts are the raw samples, pprof scales them with the sampling rate of the header (heap_v2/<PROFILE>).
+	//   • The mappings of the process (/proc/self/maps) go at the end, so pprof can symbolize the addresses.
+	//   • Nothing is locked, so it does not stop other threads.
+
+#pragma endregion
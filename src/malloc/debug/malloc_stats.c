@@ -0,0 +1,86 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   malloc_stats.c                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vzurera- <vzurera-@student.42malaga.com    +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 19:34:48 by vzurera-          #+#    #+#             */
+/*   Updated: 2026/10/17 19:34:48 by vzurera-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#pragma region "Includes"
+
+	#include "arena.h"
+
+#pragma endregion
+
+#pragma region "Print"
+
+	static void print_stats(t_stats *stats, size_t retained) {
+		size_t allocs = 0, frees = 0;
+
+		for (int i = 0; i < (int)STATS_CLASSES; ++i) {
+			allocs += stats->allocs[i];
+			frees += stats->frees[i];
+		}
+
+		aprintf(2, 0, " • Mapped: %u bytes\n", stats->mapped);
+		aprintf(2, 0, " • In use: %u bytes\n", stats->in_use);
+		aprintf(2, 0, " • Retained: %u bytes\n", retained);
+		aprintf(2, 0, " • Allocations: %u\t• Frees: %u\n", allocs, frees);
+		aprintf(2, 0, " • TINY: %u \t\t• SMALL: %u\n", stats->heaps[TINY], stats->heaps[SMALL]);
+		aprintf(2, 0, " • MEDIUM: %u\t\t• LARGE: %u\n", stats->heaps[MEDIUM], stats->heaps[LARGE]);
+	}
+
+#pragma endregion
+
+#pragma region "Malloc Stats"
+
+	__attribute__((visibility("default")))
+	void malloc_stats() {
+		ensure_init();
+
+		t_arena	*arena = &g_manager.arena;
+		int		arena_count = __atomic_load_n(&g_manager.arena_count, __ATOMIC_ACQUIRE);
+
+		for (int i = 0; i < arena_count && arena; ++i) {
+			t_stats stats;
+
+			stats_load(arena, &stats);
+			aprintf(2, 0, "————————————\n");
+			aprintf(2, 0, " • Arena #%d\n", arena->id);
+			aprintf(2, 0, "—————————————————————————————————————————\n");
+			print_stats(&stats, __atomic_load_n(&arena->retained, __ATOMIC_RELAXED));
+			aprintf(2, 0, "—————————————————————————————————————————\n\n");
+
+			arena = __atomic_load_n(&arena->next, __ATOMIC_ACQUIRE);
+		}
+
+		t_stats	total;
+		size_t	retained = 0;
+		int		count = stats_total(&total, &retained);
+
+		aprintf(2, 0, "———————————————————————————————————————————————————————————————\n");
+		aprintf(2, 0, " • Total across %d arena%s\n", count, count == 1 ? "" : "s");
+		aprintf(2, 0, "———————————————————————————————————————————————————————————————\n");
+		print_stats(&total, retained);
+	}
+
+#pragma endregion
+
+#pragma region "Information"
+
+	// Prints the memory usage of each arena and the total.
+	//
+	//   void malloc_stats(void);
+	//
+	//   • Bytes mapped, in use and retained, number of allocations and frees, and active heaps of each type.
+	//
+	// Notes:
+	//   • Output is written to file descriptor 2 (stderr).
+	//   • No arena is locked, so it does not stop other threads (see mallinfo2() for the meaning of each value).
+	//   • Allocations and frees served by a thread cache show up after the thread locks its arena again.
+
+#pragma endregion
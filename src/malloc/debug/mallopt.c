@@ -43,13 +43,25 @@
 	//   • M_ARENA_TEST (-7)         (1-160):  Number of arenas at which a hard limit on arenas is computed.
 	//   • M_PERTURB (-6)          (0-32/64):  Sets memory to the PERTURB value on allocation, and to value ^ 255 on free.
 	//   • M_CHECK_ACTION (-5)         (0-2):  Behaviour on abort errors (0: abort, 1: warning, 2: silence).
+	//   • M_MMAP_THRESHOLD (-3)     (2048-1M):  Requests above this size are served by mmap (default: dynamic, raised when LARGE blocks are freed).
 	//   • M_MIN_USAGE (3)           (0-100):  Heaps under this usage % are skipped (unless all are under).
 	//   • M_DEBUG (7)                 (0-1):  Enables debug mode (1: errors, 2: system).
 	//   • M_LOGGING (8)               (0-1):  Enables logging mode (1: to file, 2: to stderr).
+	//   • M_HEAP_GROWTH (9)           (1-8):  Each new TINY/SMALL/MEDIUM heap is this many times larger than the previous one (1: fixed size).
+	//   • M_HEAP_MAX (10)            (1-16):  Max size in MiB of a TINY/SMALL/MEDIUM heap (TINY/SMALL stop at the size of a superblock).
+	//   • M_RETAIN_MAX (11)        (0-1024):  Max MiB of empty heaps kept mapped per arena (0: disabled).
+	//   • M_RETAIN_DECAY (12)   (0-3600000):  Time in ms an empty heap is kept mapped before being unmapped.
+	//   • M_HUGE_PAGES (13)           (0-2):  Huge pages for heaps and LARGE blocks of 2 MiB or more (0: disabled, 1: transparent, 2: hugetlbfs).
+	//   • M_ARENA_CPU (14)            (0-1):  Prefer the arena of the current CPU when several are equally loaded.
+	//   • M_LATENCY (15)        (0-1000000):  Sample one in this many malloc/free/realloc calls of each thread into latency histograms (0: disabled).
+	//   • M_TRACING (16)              (0-1):  Writes a binary trace of allocations and frees to a file (decoded with tester/tests/trace_decode.c).
+	//   • M_PROFILE (17)             (0-1G):  Average bytes allocated between heap profile samples (0: disabled, see malloc_profile_dump()).
 	//
 	// Notes:
 	//   • Changes are not allowed after the first memory allocation.
 	//   • If both M_DEBUG and M_LOGGING are enabled:
 	//       – uses $MALLOC_LOGFILE if defined, or fallback to "/tmp/malloc_[PID].log"
+	//   • If M_TRACING is enabled:
+	//       – uses $MALLOC_TRACEFILE if defined, or fallback to "/tmp/malloc_[PID].trace"
 
 #pragma endregion
@@ -0,0 +1,57 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   free_aligned_sized.c                               :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vzurera- <vzurera-@student.42malaga.com    +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 17:48:20 by vzurera-          #+#    #+#             */
+/*   Updated: 2026/10/17 17:48:20 by vzurera-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#pragma region "Includes"
+
+	#include "arena.h"
+
+#pragma endregion
+
+#pragma region "Free Aligned Sized"
+
+	__attribute__((visibility("default")))
+	void free_aligned_sized(void *ptr, size_t alignment, size_t size) {
+		ensure_init();
+
+		if (!ptr) return ;
+
+		// Not aligned
+		if (!alignment || !is_power_of_two(alignment) || (uintptr_t)ptr % alignment) {
+			if (print_log(1))		aprintf(g_manager.options.fd_out, 1, "%p\t  [ERROR] Invalid pointer (free_aligned_sized: not aligned)\n", ptr);
+			if (print_error())		aprintf(2, 0, "free_aligned_sized: Invalid pointer\n");
+			abort_now(); return ;
+		}
+
+		release_sized(ptr, size);
+	}
+
+#pragma endregion
+
+#pragma region "Information"
+
+	// Frees a block of memory allocated with aligned_alloc() whose size is known by the caller (C23).
+	//
+	//   void free_aligned_sized(void *ptr, size_t alignment, size_t size);
+	//
+	//   ptr       – pointer returned by aligned_alloc().
+	//   alignment – the alignment requested when the block was allocated.
+	//   size      – the size requested when the block was allocated.
+	//
+	//   • On success: the memory block pointed to by ptr is deallocated.
+	//   • On failure: undefined behavior.
+	//
+	// Notes:
+	//   • ptr can be NULL. In that case, free_aligned_sized() does nothing.
+	//   • The pointer must be aligned to alignment (a power of two), otherwise it is reported as an invalid pointer.
+	//   • SMALL blocks go straight to the thread cache bin of that size, without working it out from the block.
+
+#pragma endregion
@@ -0,0 +1,56 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   free_batch.c                                       :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vzurera- <vzurera-@student.42malaga.com    +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 17:05:31 by vzurera-          #+#    #+#             */
+/*   Updated: 2026/10/17 17:05:31 by vzurera-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#pragma region "Includes"
+
+	#include "arena.h"
+
+#pragma endregion
+
+#pragma region "Free Batch"
+
+	__attribute__((visibility("default")))
+	void free_batch(void **ptrs, size_t n) {
+		ensure_init();
+
+		if (!ptrs || !n) return ;
+
+		// Before the free, so the events go before the next allocation of these pointers
+		for (size_t i = 0; i < n && (g_manager.options.TRACING || g_manager.options.PROFILE); ++i) {
+			if (!ptrs[i]) continue;
+			if (g_manager.options.TRACING) trace_event(TRACE_FREE, ptrs[i], 0, 0);
+			if (g_manager.options.PROFILE) profile_free(ptrs[i]);
+		}
+
+		release_batch(ptrs, n);
+	}
+
+#pragma endregion
+
+#pragma region "Information"
+
+	// Frees several blocks of memory at once.
+	//
+	//   void free_batch(void **ptrs, size_t n);
+	//
+	//   ptrs – array of pointers returned by malloc/calloc/realloc/malloc_batch.
+	//   n    – number of pointers in the array.
+	//
+	//   • On success: every block in ptrs[0..n-1] is deallocated.
+	//   • On failure: undefined behavior.
+	//
+	// Notes:
+	//   • NULL entries are ignored, like in free().
+	//   • The pointers are grouped by the arena that owns them (in windows of 64), so each arena is locked once per window.
+	//   • The thread cache is bypassed: the blocks go straight back to their heaps.
+
+#pragma endregion
@@ -0,0 +1,47 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   free_sized.c                                       :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vzurera- <vzurera-@student.42malaga.com    +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 17:48:20 by vzurera-          #+#    #+#             */
+/*   Updated: 2026/10/17 17:48:20 by vzurera-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#pragma region "Includes"
+
+	#include "arena.h"
+
+#pragma endregion
+
+#pragma region "Free Sized"
+
+	__attribute__((visibility("default")))
+	void free_sized(void *ptr, size_t size) {
+		ensure_init();
+
+		release_sized(ptr, size);
+	}
+
+#pragma endregion
+
+#pragma region "Information"
+
+	// Frees a block of memory whose size is known by the caller (C23).
+	//
+	//   void free_sized(void *ptr, size_t size);
+	//
+	//   ptr  – pointer returned by malloc/calloc/realloc.
+	//   size – the size requested when the block was allocated.
+	//
+	//   • On success: the memory block pointed to by ptr is deallocated.
+	//   • On failure: undefined behavior.
+	//
+	// Notes:
+	//   • ptr can be NULL. In that case, free_sized() does nothing.
+	//   • TINY and SMALL blocks go straight to the thread cache bin of that size, without working it out from the block.
+	//   • If the size does not match the block, it is freed like with free().
+
+#pragma endregion
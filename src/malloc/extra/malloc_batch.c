@@ -0,0 +1,52 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   malloc_batch.c                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vzurera- <vzurera-@student.42malaga.com    +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 17:05:31 by vzurera-          #+#    #+#             */
+/*   Updated: 2026/10/17 17:05:31 by vzurera-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#pragma region "Includes"
+
+	#include "arena.h"
+
+#pragma endregion
+
+#pragma region "Malloc Batch"
+
+	__attribute__((visibility("default")))
+	size_t malloc_batch(size_t size, size_t n, void **out) {
+		ensure_init();
+
+		if (!n) return (0);
+		if (!out) { errno = EINVAL; return (0); }
+
+		return (allocate_batch(SRC_MALLOC_BATCH, size, n, out));
+	}
+
+#pragma endregion
+
+#pragma region "Information"
+
+	// Allocates several blocks of the same size at once.
+	//
+	//   size_t malloc_batch(size_t size, size_t n, void **out);
+	//
+	//   size – the size of each block, in bytes.
+	//   n    – number of blocks to allocate.
+	//   out  – array of at least n pointers where the blocks are stored.
+	//
+	//   • On success: returns n, and out[0..n-1] point to the new blocks.
+	//   • On failure: returns the number of blocks allocated (stored in out[0..count-1]) and sets errno to:
+	//       – ENOMEM: not enough memory.
+	//       – EINVAL: out is NULL.
+	//
+	// Notes:
+	//   • The whole batch is served under a single arena lock, carving consecutive blocks from the same slab or heap.
+	//   • Each block is independent and can be released with free() or free_batch().
+
+#pragma endregion
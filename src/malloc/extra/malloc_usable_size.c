@@ -42,6 +42,21 @@
 			return (0);
 		}
 
+		// TINY
+		if (heap->type == TINY) {
+			size_t slab_size = slab_usable(ptr, heap);
+			if (!slab_size || SLAB_CACHED(ptr)) {
+				if (print_log(1))		aprintf(g_manager.options.fd_out, 1, "%p\t  [ERROR] Invalid pointer (malloc_usable_size: in middle of chunk)\n", ptr);
+				if (print_error())		aprintf(2, 0, "malloc_usable_size: Invalid pointer\n");
+				abort_now();
+				return (0);
+			}
+
+			if (print_log(0)) aprintf(g_manager.options.fd_out, 1, "%p\t[MALLOC_USABLE_SIZE] %d bytes available in chunk\n", ptr, slab_size);
+
+			return (slab_size);
+		}
+
 		// LARGE
 		if (heap->type == LARGE) {
 				if (GET_HEAD(ptr) != heap->ptr) {
@@ -110,7 +125,7 @@
 					abort_now(); return (0);
 				}
 
-				if (ptr < ZERO_MALLOC_BASE || ptr >= (void *)((char *)ZERO_MALLOC_BASE + (g_manager.alloc_zero_counter * ALIGNMENT))) {
+				if (ptr < ZERO_MALLOC_BASE || ptr >= (void *)((char *)ZERO_MALLOC_BASE + (__atomic_load_n(&g_manager.alloc_zero_counter, __ATOMIC_RELAXED) * ALIGNMENT))) {
 					if (print_log(1))		aprintf(g_manager.options.fd_out, 1, "%p\t  [ERROR] Invalid pointer (malloc_usable_size: not allocated)\n", ptr);
 					if (print_error())		aprintf(2, 0, "malloc_usable_size: Invalid pointer\n");
 					mutex(&g_manager.mutex, MTX_UNLOCK);
@@ -123,35 +138,15 @@
 			return (0);
 		}
 
-		t_arena	*arena = tcache;
-		t_heap	*heap_ptr = NULL;
+		t_heap	*heap_ptr = pagemap_get(ptr);
 		size_t	chunk_size = 0;
 
-		if (!arena) arena = &g_manager.arena;
-		if (arena) {
-			mutex(&arena->mutex, MTX_LOCK);
+		if (heap_ptr) {
+			mutex(&heap_ptr->arena->mutex, MTX_LOCK);
 
-				if ((heap_ptr = heap_find(arena, ptr))) chunk_size = usable_ptr(ptr, heap_ptr);
+				chunk_size = usable_ptr(ptr, heap_ptr);
 
-			mutex(&arena->mutex, MTX_UNLOCK);
-		}
-
-		if (!heap_ptr) {
-			mutex(&g_manager.mutex, MTX_LOCK);
-
-				t_arena *curr_arena = &g_manager.arena;
-				while (curr_arena) {
-					if (arena == curr_arena) { curr_arena = curr_arena->next; continue; }
-					mutex(&curr_arena->mutex, MTX_LOCK);
-
-						if ((heap_ptr = heap_find(curr_arena, ptr))) chunk_size = usable_ptr(ptr, heap_ptr);
-
-					mutex(&curr_arena->mutex, MTX_UNLOCK);
-					if (heap_ptr) break;
-					curr_arena = curr_arena->next;
-				}
-
-			mutex(&g_manager.mutex, MTX_UNLOCK);
+			mutex(&heap_ptr->arena->mutex, MTX_UNLOCK);
 		}
 
 		return (chunk_size);
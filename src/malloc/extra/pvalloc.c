@@ -28,12 +28,7 @@
 		size = (size + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1);
 
 		if (!size) {
-			mutex(&g_manager.mutex, MTX_LOCK);
-
-				size_t aligned_offset = (g_manager.alloc_zero_counter * PAGE_SIZE);
-				g_manager.alloc_zero_counter++;
-				
-			mutex(&g_manager.mutex, MTX_UNLOCK);
+			size_t aligned_offset = (__atomic_fetch_add(&g_manager.alloc_zero_counter, 1, __ATOMIC_RELAXED) * PAGE_SIZE);
 
 			ptr = (void*)(ZERO_MALLOC_BASE + aligned_offset);
 			if (ptr && print_log(0))	aprintf(g_manager.options.fd_out, 1, "%p\t [VALLOC] Allocated %u bytes\n", ptr, size);
@@ -42,7 +37,7 @@
 			return (ptr);
 		}
 
-		ptr = allocate_aligned("PVCALLOC", PAGE_SIZE, size);
+		ptr = allocate_aligned(SRC_PVALLOC, PAGE_SIZE, size);
 
 		return (ptr);
 	}
@@ -40,6 +40,16 @@
 			return (abort_now());
 		}
 
+		// TINY
+		if (heap->type == TINY) {
+			if (slab_check(ptr, heap) || SLAB_CACHED(ptr)) {
+				if (print_log(1))		aprintf(g_manager.options.fd_out, 1, "%p\t  [ERROR] Invalid pointer (reallocarray: in middle of chunk)\n", ptr);
+				if (print_error())		aprintf(2, 0, "reallocarray: Invalid pointer\n");
+				return (abort_now());
+			}
+			return (0);
+		}
+
 		// LARGE
 		if (heap->type == LARGE) {
 				if (GET_HEAD(ptr) != heap->ptr) {
@@ -88,44 +98,23 @@
 		if (nmemb && size && nmemb > SIZE_MAX / size) { errno = ENOMEM; return (NULL); }
 		size = nmemb * size;
 			
-		if (!ptr)			return allocate("REALLOC_ARRAY", size);		// ptr NULL is equivalent to malloc(size)
+		if (!ptr)			return allocate(SRC_REALLOC_ARRAY, size);		// ptr NULL is equivalent to malloc(size)
 		if (!size)			return (free(ptr), NULL);					// size 0 is equivalent to free(ptr)
 		if (!arena_find()) 	return (NULL);
 
 		// alloc zero
 		if (check_digit(ptr, ZERO_MALLOC_BASE)) {
-			mutex(&g_manager.mutex, MTX_LOCK);
-
-				if (ptr > ZERO_MALLOC_BASE && ptr < (void *)((char *)ZERO_MALLOC_BASE + (g_manager.alloc_zero_counter * ALIGNMENT))) {
-					mutex(&g_manager.mutex, MTX_UNLOCK);
-					return allocate("REALLOC_ARRAY", size);
-				}
-			
-			mutex(&g_manager.mutex, MTX_UNLOCK);
+			if (ptr > ZERO_MALLOC_BASE && ptr < (void *)((char *)ZERO_MALLOC_BASE + (__atomic_load_n(&g_manager.alloc_zero_counter, __ATOMIC_RELAXED) * ALIGNMENT)))
+				return allocate(SRC_REALLOC_ARRAY, size);
 		}
 	
 		void	*new_ptr = NULL;
 		bool	is_new = false;
-		t_heap	*heap = NULL;
-		t_arena	*arena = &g_manager.arena;
+		bool	demote = false;
+		t_heap	*heap = pagemap_get(ptr);
+		t_arena	*arena = (heap) ? heap->arena : NULL;
 		size_t	old_size = 0;
 
-		mutex(&g_manager.mutex, MTX_LOCK);
-
-			while (arena) {
-				mutex(&arena->mutex, MTX_LOCK);
-
-					if ((heap = heap_find(arena, ptr)) && heap->active) {
-						mutex(&arena->mutex, MTX_UNLOCK);
-						break;
-					}
-
-				mutex(&arena->mutex, MTX_UNLOCK);
-				arena = arena->next;
-			}
-
-		mutex(&g_manager.mutex, MTX_UNLOCK);
-
 		if (!arena || !heap || !heap->active) {
 			if (print_log(1))		aprintf(g_manager.options.fd_out, 1, "%p\t  [ERROR] Invalid pointer (reallocarray: heap may be unmamped)\n", ptr);
 			if (print_error())		aprintf(2, 0, "reallocarray: Invalid pointer\n");
@@ -139,19 +128,25 @@
 				return (abort_now(), NULL);
 			}
 
-			old_size = GET_SIZE((t_chunk *)GET_HEAD(ptr));
+			old_size = (heap->type == TINY) ? GET_SLAB(ptr)->size : GET_SIZE((t_chunk *)GET_HEAD(ptr));
 			t_chunk *chunk = GET_HEAD(ptr);
-			size_t	chunk_size = GET_SIZE(chunk);
-			if (ALIGN(size) <= chunk_size) {
-				if (heap->type == LARGE) new_ptr = ptr;
-				else {
-					size_t remaining = chunk_size - ALIGN(size);
-					if (remaining >= sizeof(t_chunk) + ((heap->type == TINY) ? 48 : TINY_CHUNK)) {
-						chunk->size = (chunk->size & (HEAP_TYPE | PREV_INUSE)) | ALIGN(size);
-						t_chunk *new_chunk = (t_chunk *)((char *)chunk + ALIGN(size) + sizeof(t_chunk));
-						SET_PREV_SIZE(new_chunk, ALIGN(size));
+			size_t	chunk_size = old_size;
+			size_t	user_size = (heap->type == TINY) ? ALIGN(size) : CHUNK_SIZE(size) - sizeof(t_chunk);
+			if (heap->type == TINY) {
+				if (user_size <= chunk_size) new_ptr = ptr;
+			} else if (user_size <= chunk_size) {
+				if (heap->type == LARGE) {
+					// Small enough for a heap: move it there (small copy), otherwise give back the pages after the new end
+					demote = ALIGN(size + sizeof(t_chunk)) <= __atomic_load_n(&g_manager.mmap_threshold, __ATOMIC_RELAXED);
+					if (!demote) new_ptr = heap_remap(heap, size);
+					if (!demote && !new_ptr) new_ptr = ptr;
+				} else {
+					size_t remaining = chunk_size - user_size;
+					if (remaining >= sizeof(t_chunk) + TINY_CHUNK) {
+						chunk->size = (chunk->size & (HEAP_TYPE | PREV_INUSE)) | user_size;
+						t_chunk *new_chunk = (t_chunk *)((char *)chunk + user_size + sizeof(t_chunk));
 						SET_POISON(GET_PTR(new_chunk));
-						new_chunk->size = (remaining - sizeof(t_chunk)) | ((heap->type == SMALL) ? HEAP_TYPE : 0) | PREV_INUSE;
+						new_chunk->size = (remaining - sizeof(t_chunk)) | HEAP_TYPE | PREV_INUSE;
 						t_chunk *next_chunk = GET_NEXT(new_chunk);
 						SET_PREV_SIZE(next_chunk, remaining - sizeof(t_chunk));
 						next_chunk->size &= ~PREV_INUSE;
@@ -160,8 +155,11 @@
 						new_ptr = ptr;
 					} else new_ptr = ptr;
 				}
-			} else if (heap->type != LARGE) {
-				size_t needed_size = ALIGN(size);
+			} else if (heap->type == LARGE) {
+				// Grow the mapping (in place or moved by the kernel, without copying)
+				new_ptr = heap_remap(heap, size);
+			} else if (heap->type == SMALL || heap->type == MEDIUM) {
+				size_t needed_size = user_size;
 				size_t current_size = GET_SIZE(chunk);
 
 				if (needed_size > current_size) {
@@ -170,7 +168,7 @@
 					t_chunk *next = GET_NEXT(chunk);
 					bool can_extend = false;
 					
-					if (needed_size < ((heap->type == TINY) ? TINY_CHUNK : SMALL_CHUNK)) {
+					if (needed_size < ((heap->type == SMALL) ? SMALL_CHUNK : __atomic_load_n(&g_manager.mmap_threshold, __ATOMIC_RELAXED))) {
 						while (next && absorbed < extra_needed) {
 							if (!IS_TOPCHUNK(next) && !IS_FREE(next)) break;
 
@@ -183,27 +181,35 @@
 								}
 								break;
 							} else {
-								unlink_chunk(next, arena, heap);
+								if (unlink_chunk(next, arena, heap)) break;
 								absorbed += GET_SIZE(next) + sizeof(t_chunk);
-								if (absorbed >= extra_needed) { can_extend = true; break; }
-								heap->free_chunks--;
 								heap->free -= GET_SIZE(next) + sizeof(t_chunk);
+								if (absorbed >= extra_needed) { can_extend = true; break; }
 								next = GET_NEXT(next);
 							}
 						}
 
+						// Not enough space, give back the absorbed chunks as a single free chunk
+						if (!can_extend && absorbed) {
+							t_chunk *free_chunk = GET_NEXT(chunk);
+							free_chunk->size = (absorbed - sizeof(t_chunk)) | HEAP_TYPE | PREV_INUSE;
+							SET_POISON(GET_PTR(free_chunk));
+							SET_PREV_SIZE(GET_NEXT(free_chunk), absorbed - sizeof(t_chunk));
+							link_chunk(free_chunk, arena, heap);
+							heap->free += absorbed;
+						}
+
 						if (can_extend && absorbed >= extra_needed) {
 
 							chunk->size = (chunk->size & (HEAP_TYPE | PREV_INUSE)) | (current_size + absorbed);
 
-							if (current_size + absorbed > ALIGN(size)) {
-								size_t remaining = (current_size + absorbed) - ALIGN(size);
-								if (remaining >= sizeof(t_chunk) + ((heap->type == TINY) ? 48 : TINY_CHUNK)) {
-									chunk->size = (chunk->size & (HEAP_TYPE | PREV_INUSE)) | ALIGN(size);
-									t_chunk *new_chunk = (t_chunk *)((char *)chunk + ALIGN(size) + sizeof(t_chunk));
-									SET_PREV_SIZE(new_chunk, ALIGN(size));
+							if (current_size + absorbed > user_size) {
+								size_t remaining = (current_size + absorbed) - user_size;
+								if (remaining >= sizeof(t_chunk) + TINY_CHUNK) {
+									chunk->size = (chunk->size & (HEAP_TYPE | PREV_INUSE)) | user_size;
+									t_chunk *new_chunk = (t_chunk *)((char *)chunk + user_size + sizeof(t_chunk));
 									SET_POISON(GET_PTR(new_chunk));
-									new_chunk->size = (remaining - sizeof(t_chunk)) | ((heap->type == SMALL) ? HEAP_TYPE : 0) | PREV_INUSE;
+									new_chunk->size = (remaining - sizeof(t_chunk)) | HEAP_TYPE | PREV_INUSE;
 									t_chunk *next_chunk = GET_NEXT(new_chunk);
 									SET_PREV_SIZE(next_chunk, remaining - sizeof(t_chunk));
 									next_chunk->size &= ~PREV_INUSE;
@@ -223,20 +229,32 @@
 					}
 				} else new_ptr = ptr;
 			}
+
+			// Resized in place
+			if (new_ptr && heap->type != TINY) STATS_ADD(arena->stats.in_use, GET_SIZE((t_chunk *)GET_HEAD(new_ptr)) - old_size);
 		
 			mutex(&arena->mutex, MTX_UNLOCK);
 
-			if (new_ptr == ptr && old_size && print_log(0)) {
-				size_t req_size = ALIGN(size);
+			if (new_ptr && old_size && g_manager.options.TRACING)
+				trace_event((user_size > old_size) ? TRACE_EXTEND : (user_size < old_size) ? TRACE_SHRINK : TRACE_SAME, new_ptr, user_size, SRC_REALLOC_ARRAY);
+
+			// Resized in place: the sample of the old size is dropped, and the new size counts as a new allocation
+			if (new_ptr && old_size && g_manager.options.PROFILE) {
+				profile_free(new_ptr);
+				if (PROFILE_SAMPLED(user_size)) profile_alloc(new_ptr, user_size);
+			}
+
+			if (new_ptr && old_size && print_log(0)) {
+				size_t req_size = user_size;
 				if (req_size > old_size)
-					aprintf(g_manager.options.fd_out, 1, "%p\t [REALLOC_ARRAY] Extended to %u bytes\n", ptr, req_size);
+					aprintf(g_manager.options.fd_out, 1, "%p\t [REALLOC_ARRAY] Extended to %u bytes\n", new_ptr, req_size);
 				else if (req_size < old_size)
-					aprintf(g_manager.options.fd_out, 1, "%p\t [REALLOC_ARRAY] Shrunk to %u bytes\n", ptr, req_size);
+					aprintf(g_manager.options.fd_out, 1, "%p\t [REALLOC_ARRAY] Shrunk to %u bytes\n", new_ptr, req_size);
 				else
-					aprintf(g_manager.options.fd_out, 1, "%p\t [REALLOC_ARRAY] Size unchanged %u bytes\n", ptr, req_size);
+					aprintf(g_manager.options.fd_out, 1, "%p\t [REALLOC_ARRAY] Size unchanged %u bytes\n", new_ptr, req_size);
 			}
 
-		if (new_ptr && g_manager.options.PERTURB && heap->type != LARGE) {
+		if (new_ptr && g_manager.options.PERTURB && (heap->type == SMALL || heap->type == MEDIUM)) {
 			size_t new_size = GET_SIZE((t_chunk *)GET_HEAD(new_ptr));
 			if (new_size > old_size) {
 				size_t len = new_size - old_size;
@@ -245,13 +263,16 @@
 		}
 			
 		if (!new_ptr) {
-			new_ptr = allocate("REALLOC_ARRAY", ALIGN(size + sizeof(t_chunk)));
+			new_ptr = allocate(SRC_REALLOC_ARRAY, ALIGN(size + sizeof(t_chunk)));
 			if (new_ptr) {
 				is_new = true;
 				ft_memcpy(new_ptr, ptr, (size < old_size) ? size : old_size);
 			}
 		}
 
+		// A LARGE block that could not be moved to a heap is kept as it is
+		if (!new_ptr && demote) new_ptr = ptr;
+
 		if (is_new) free(ptr);
 		return (new_ptr);
 	}
@@ -276,5 +297,7 @@
 	//   • If nmemb == 0 || size == 0:
 	//       – ptr != NULL → returns NULL, leaves ptr valid (not an error).
 	//       – ptr == NULL → returns a unique pointer you can free (malloc(0)).
+	//   • LARGE blocks grow with mremap() (in place, or moved by the kernel without copying the data).
+	//   • LARGE blocks that shrink give back the pages after the new end, or move to a heap if they fit under the mmap threshold.
 
 #pragma endregion
@@ -25,12 +25,7 @@
 		void *ptr = NULL;
 
 		if (!size) {
-			mutex(&g_manager.mutex, MTX_LOCK);
-
-				size_t aligned_offset = (g_manager.alloc_zero_counter * PAGE_SIZE);
-				g_manager.alloc_zero_counter++;
-				
-			mutex(&g_manager.mutex, MTX_UNLOCK);
+			size_t aligned_offset = (__atomic_fetch_add(&g_manager.alloc_zero_counter, 1, __ATOMIC_RELAXED) * PAGE_SIZE);
 
 			ptr = (void*)(ZERO_MALLOC_BASE + aligned_offset);
 			if (ptr && print_log(0))	aprintf(g_manager.options.fd_out, 1, "%p\t [VALLOC] Allocated %u bytes\n", ptr, size);
@@ -39,7 +34,7 @@
 			return (ptr);
 		}
 
-		ptr = allocate_aligned("VALLOC", PAGE_SIZE, size);
+		ptr = allocate_aligned(SRC_VALLOC, PAGE_SIZE, size);
 
 		return (ptr);
 	}
@@ -24,7 +24,7 @@
 
 		if (nmemb && size && nmemb > SIZE_MAX / size) return (NULL);
 
-		return (allocate("CALLOC", nmemb * size));
+		return (allocate(SRC_CALLOC, nmemb * size));
 	}
 
 #pragma endregion
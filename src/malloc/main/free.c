@@ -32,6 +32,15 @@
 					return (abort_now());
 				}
 
+				// Dynamic threshold (a freed LARGE chunk means that size is not long-lived, so serve it from MEDIUM heaps)
+				size_t chunk_size = GET_SIZE((t_chunk *)GET_HEAD(ptr));
+				if (g_manager.options.MMAP_THRESHOLD < 0 && chunk_size <= MMAP_THRESHOLD_MAX && chunk_size > __atomic_load_n(&g_manager.mmap_threshold, __ATOMIC_RELAXED)) {
+					__atomic_store_n(&g_manager.mmap_threshold, chunk_size, __ATOMIC_RELAXED);
+					if (print_log(2)) aprintf(g_manager.options.fd_out, 1, "\t\t [SYSTEM] Mmap threshold raised to %u bytes\n", chunk_size);
+				}
+
+				STATS_SUB(arena->stats.in_use, chunk_size);
+				STATS_ADD(arena->stats.frees[STATS_CLASS(chunk_size)], 1);
 				if (!heap_destroy(heap)) arena->free_count++;
 				return (0);
 			}
@@ -73,6 +82,8 @@
 
 		SET_POISON(ptr);
 		heap->free += GET_SIZE(chunk) + sizeof(t_chunk);
+		STATS_SUB(arena->stats.in_use, GET_SIZE(chunk));
+		STATS_ADD(arena->stats.frees[STATS_CLASS(GET_SIZE(chunk))], 1);
 
 		// Add to bins
 		next_chunk->size &= ~PREV_INUSE;
@@ -85,13 +96,12 @@
 		if (heap->free >= heap->size) {
 			if (heap_can_removed(arena, heap)) {
 				t_chunk *chunk = heap->ptr;
-				bool cancel = false;
-				while (!IS_TOPCHUNK(chunk)) {
-					cancel = unlink_chunk(chunk, arena, heap);
-					if (cancel) break;
-					chunk = GET_NEXT(chunk);
+				while (!IS_TOPCHUNK(chunk) && IS_FREE(chunk)) chunk = GET_NEXT(chunk);
+				if (IS_TOPCHUNK(chunk)) {
+					for (chunk = heap->ptr; !IS_TOPCHUNK(chunk); chunk = GET_NEXT(chunk))
+						unlink_chunk(chunk, arena, heap);
+					heap_destroy(heap);
 				}
-				if (!cancel) heap_destroy(heap);
 			}
 		}
 
@@ -102,14 +112,106 @@
 	
 #pragma endregion
 
-#pragma region "Free"
+#pragma region "Remote"
 
-	__attribute__((visibility("default")))
-	void free(void *ptr) {
-		ensure_init();
+	#pragma region "Push"
 
-		if (!ptr) return;
+		static int remote_push(t_arena *arena, void *ptr, t_heap *heap) {
+			if (g_manager.options.DEBUG || g_manager.options.LOGGING) return (1);
+			if (!heap->active || heap->type == LARGE) return (1);
+
+			// Slab objects are linked through their first word
+			void **link = (void **)ptr;
+			if (heap->type == TINY) {
+				if (slab_check(ptr, heap)) return (1);
+
+				// Double free (still allocated in the slab until the owner drains it)
+				if (SET_SLAB_CACHED(ptr) & (1ULL << (SLAB_BIT(ptr) % 64))) {
+					if (print_log(1))		aprintf(g_manager.options.fd_out, 1, "%p\t  [ERROR] Double free (free: remote)\n", ptr);
+					if (print_error())		aprintf(2, 0, "free: Double free\n");
+					abort_now(); return (0);
+				}
+			} else {
+				if (!HAS_MAGIC(ptr)) return (1);
+
+				t_chunk *chunk = (t_chunk *)GET_HEAD(ptr);
+				if (chunk->size & (TOP_CHUNK | MMAP_CHUNK)) return (1);
+				t_chunk *next_chunk = GET_NEXT(chunk);
+				if (!(next_chunk->size & PREV_INUSE)) return (1);
 
+				SET_POISON(ptr);
+			}
+
+			void *head = __atomic_load_n(&arena->remote_free, __ATOMIC_RELAXED);
+			do {
+				*link = head;
+			} while (!__atomic_compare_exchange_n(&arena->remote_free, &head, ptr, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+
+			return (0);
+		}
+
+	#pragma endregion
+
+	#pragma region "Drain"
+
+		void remote_drain(t_arena *arena) {
+			if (!arena || !__atomic_load_n(&arena->remote_free, __ATOMIC_RELAXED)) return ;
+
+			void *ptr = __atomic_exchange_n(&arena->remote_free, NULL, __ATOMIC_ACQUIRE);
+			while (ptr) {
+				void	*next = *(void **)ptr;
+				t_heap	*heap = pagemap_get(ptr);
+
+				if (heap->type == TINY) {
+					CLEAR_SLAB_CACHED(ptr);
+					slab_free(arena, ptr, heap);
+				} else {
+					SET_MAGIC(ptr);
+					free_ptr(arena, ptr, heap);
+				}
+
+				ptr = next;
+			}
+		}
+
+	#pragma endregion
+
+#pragma endregion
+
+#pragma region "Release PTR"
+
+	void release_ptr(void *ptr) {
+		t_heap *heap = pagemap_get(ptr);
+		if (!heap) return ;
+
+		t_arena *arena = heap->arena;
+		thread_cache.path = LAT_BIN;
+		if (arena != tcache && !remote_push(arena, ptr, heap)) return ;
+
+		mutex(&arena->mutex, MTX_LOCK);
+
+			remote_drain(arena);
+
+			if (heap->active && ptr >= heap->ptr && ptr < (void *)((char *)heap->ptr + heap->size)) {
+				if (heap->type == TINY)	slab_free(arena, ptr, heap);
+				else					free_ptr(arena, ptr, heap);
+				mutex(&arena->mutex, MTX_UNLOCK);
+				return ;
+			}
+
+		mutex(&arena->mutex, MTX_UNLOCK);
+
+		// Heap freed
+		if (print_log(1))		aprintf(g_manager.options.fd_out, 1, "%p\t  [ERROR] Invalid pointer (free: heap may be unmamped)\n", ptr);
+		if (print_error())		aprintf(2, 0, "free: Invalid pointer\n");
+		abort_now();
+	}
+
+#pragma endregion
+
+#pragma region "Free Memory"
+
+	static void free_memory(void *ptr) {
 		// Not aligned
 		if ((uintptr_t)ptr % ALIGNMENT) {
 			if (print_log(1))		aprintf(g_manager.options.fd_out, 1, "%p\t  [ERROR] Invalid pointer (free: not aligned)\n", ptr);
@@ -119,55 +221,135 @@
 
 		// alloc zero
 		if (check_digit(ptr, ZERO_MALLOC_BASE)) {
-			mutex(&g_manager.mutex, MTX_LOCK);
-
-				if (ptr > ZERO_MALLOC_BASE && ptr < (void *)((char *)ZERO_MALLOC_BASE + (g_manager.alloc_zero_counter * ALIGNMENT))) {
-					if (print_log(0))	aprintf(g_manager.options.fd_out, 1, "%p\t   [FREE] Memory freed of size 0 bytes\n", ptr);
+			if (ptr > ZERO_MALLOC_BASE && ptr < (void *)((char *)ZERO_MALLOC_BASE + (__atomic_load_n(&g_manager.alloc_zero_counter, __ATOMIC_RELAXED) * ALIGNMENT))) {
+				if (print_log(0))	aprintf(g_manager.options.fd_out, 1, "%p\t   [FREE] Memory freed of size 0 bytes\n", ptr);
+				if (arena_find()) {
 					mutex(&tcache->mutex, MTX_LOCK);
 
 						tcache->free_count--;
 
 					mutex(&tcache->mutex, MTX_UNLOCK);
 				}
-			
-			mutex(&g_manager.mutex, MTX_UNLOCK);
+			}
+
 			return ;
 		}
 
-		t_arena	*arena = &g_manager.arena;
-		t_heap	*heap = NULL;
-		t_heap	*inactive = NULL;
+		// Thread cache
+		if (!cache_put(ptr)) return ;
+
+		release_ptr(ptr);
+	}
+
+#pragma endregion
+
+#pragma region "Release Sized"
+
+	void release_sized(void *ptr, size_t size) {
+		if (!ptr) return ;
+
+		// malloc(0) and misaligned pointers need the checks of free()
+		if (!size || (uintptr_t)ptr % ALIGNMENT) { free(ptr); return ; }
+
+		if (g_manager.options.TRACING) trace_event(TRACE_FREE, ptr, size, 0);
+		if (g_manager.options.PROFILE) profile_free(ptr);
+
+		// Thread cache (bin taken from the size, or from the chunk if they do not agree)
+		if (!cache_put_sized(ptr, size) || !cache_put(ptr)) return ;
+
+		release_ptr(ptr);
+	}
+
+#pragma endregion
 
-		mutex(&g_manager.mutex, MTX_LOCK);
+#pragma region "Release Batch"
+
+	void release_batch(void **ptrs, size_t n) {
+		for (size_t base = 0; base < n; base += 64) {
+			size_t		count = (n - base < 64) ? n - base : 64;
+			t_arena		*arenas[64];
+			uint64_t	pending = 0;
+
+			// Windows of 64 pointers (one bit each). NULL, malloc(0) and invalid pointers take the normal path
+			for (size_t i = 0; i < count; ++i) {
+				void	*ptr = ptrs[base + i];
+				t_heap	*heap = (ptr && !((uintptr_t)ptr % ALIGNMENT)) ? pagemap_get(ptr) : NULL;
+
+				if (heap)		{ arenas[i] = heap->arena; pending |= 1ULL << i; }
+				else if (ptr)	free_memory(ptr);
+			}
+
+			// Pointers of the window are grouped by arena, so each arena is locked once
+			while (pending) {
+				t_arena		*arena = arenas[__builtin_ctzll(pending)];
+				uint64_t	invalid = 0, cached = 0;
 
-			while (arena) {
 				mutex(&arena->mutex, MTX_LOCK);
 
-					if ((heap = heap_find(arena, ptr))) {
-						if (heap->active) {
-							free_ptr(arena, ptr, heap);
-							mutex(&arena->mutex, MTX_UNLOCK);
-							mutex(&g_manager.mutex, MTX_UNLOCK);
-							return ;
-						} else inactive = heap;
+					remote_drain(arena);
+
+					for (uint64_t group = pending; group; group &= group - 1) {
+						int i = __builtin_ctzll(group);
+						if (arenas[i] != arena) continue;
+						pending &= ~(1ULL << i);
+
+						// The heap is looked up again, an earlier pointer of the batch may have freed it
+						void	*ptr = ptrs[base + i];
+						t_heap	*heap = pagemap_get(ptr);
+
+						if (!heap || heap->arena != arena || !heap->active || ptr < heap->ptr || ptr >= (void *)((char *)heap->ptr + heap->size))
+							invalid |= 1ULL << i;
+						// Still allocated in the slab while it sits in a thread cache
+						else if (heap->type == TINY && SLAB_CACHED(ptr))
+							cached |= 1ULL << i;
+						else if (heap->type == TINY)	slab_free(arena, ptr, heap);
+						else							free_ptr(arena, ptr, heap);
 					}
 
 				mutex(&arena->mutex, MTX_UNLOCK);
-				arena = arena->next;
-			}
 
-		mutex(&g_manager.mutex, MTX_UNLOCK);
+				// Heap freed
+				for (; invalid; invalid &= invalid - 1) {
+					if (print_log(1))		aprintf(g_manager.options.fd_out, 1, "%p\t  [ERROR] Invalid pointer (free_batch: heap may be unmapped)\n", ptrs[base + __builtin_ctzll(invalid)]);
+					if (print_error())		aprintf(2, 0, "free_batch: Invalid pointer\n");
+					abort_now();
+				}
 
-		// Heap freed
-		if (inactive) {
-			if (print_log(1))		aprintf(g_manager.options.fd_out, 1, "%p\t  [ERROR] Invalid pointer (free: heap may be unmamped)\n", ptr);
-			if (print_error())		aprintf(2, 0, "free: Invalid pointer\n");
-			abort_now(); return ;
+				// Slab object in a thread cache
+				for (; cached; cached &= cached - 1) {
+					if (print_log(1))		aprintf(g_manager.options.fd_out, 1, "%p\t  [ERROR] Double free (free_batch: cached)\n", ptrs[base + __builtin_ctzll(cached)]);
+					if (print_error())		aprintf(2, 0, "free_batch: Double free\n");
+					abort_now();
+				}
+			}
 		}
 	}
 
 #pragma endregion
 
+#pragma region "Free"
+
+	__attribute__((visibility("default")))
+	void free(void *ptr) {
+		ensure_init();
+
+		if (!ptr) return;
+
+		// Before the free, so the event goes before the next allocation of this pointer
+		if (g_manager.options.TRACING) trace_event(TRACE_FREE, ptr, 0, 0);
+		if (g_manager.options.PROFILE) profile_free(ptr);
+
+		if (!g_manager.options.LATENCY || !latency_sample()) { free_memory(ptr); return ; }
+
+		int			type = latency_type(ptr);
+		uint64_t	start = latency_ticks();
+
+		free_memory(ptr);
+		latency_record(LAT_FREE, type, latency_ticks() - start);
+	}
+
+#pragma endregion
+
 #pragma region "Information"
 
 	// Frees a block of memory previously allocated.
@@ -22,7 +22,7 @@
 	void *malloc(size_t size) {
 		ensure_init();
 
-		return (allocate("MALLOC", size));
+		return (allocate(SRC_MALLOC, size));
 	}
 
 #pragma endregion
@@ -6,7 +6,7 @@
 /*   By: vzurera- <vzurera-@student.42malaga.com    +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/05/31 14:11:34 by vzurera-          #+#    #+#             */
-/*   Updated: 2025/06/02 15:09:14 by vzurera-         ###   ########.fr       */
+/*   Updated: 2026/10/17 14:02:51 by vzurera-         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -14,30 +14,225 @@
 
 	#include "utils.h"
 
+	#include <stdint.h>
+
+	#if defined(__x86_64__) || defined(__i386__)
+		#include <immintrin.h>
+		#define MEM_X86
+	#endif
+
 #pragma endregion
 
-#pragma region "MEMSET"
+#pragma region "Variables"
 
-	void *ft_memset(void *b, int c, size_t len) {
+	typedef uint64_t __attribute__((may_alias, aligned(1)))	t_word;
+
+	static void *(*memset_kernel)(void *b, int c, size_t len);
+	static void *(*memcpy_kernel)(void *dst, const void *src, size_t n);
+
+#pragma endregion
+
+#pragma region "Word"
+
+	static void *memset_word(void *b, int c, size_t len) {
 		unsigned char	*p = b;
+		uint64_t		word = (unsigned char)c * 0x0101010101010101ULL;
 
+		while (len && ((uintptr_t)p & 7)) { *p++ = (unsigned char)c; len--; }
+		for (; len >= 32; len -= 32, p += 32) {
+			((t_word *)p)[0] = word; ((t_word *)p)[1] = word;
+			((t_word *)p)[2] = word; ((t_word *)p)[3] = word;
+		}
+		for (; len >= 8; len -= 8, p += 8) *(t_word *)p = word;
 		while (len--) *p++ = (unsigned char)c;
 
 		return (b);
 	}
 
+	static void *memcpy_word(void *dst, const void *src, size_t n) {
+		unsigned char		*d = dst;
+		const unsigned char	*s = src;
+
+		while (n && ((uintptr_t)d & 7)) { *d++ = *s++; n--; }
+		for (; n >= 32; n -= 32, d += 32, s += 32) {
+			((t_word *)d)[0] = ((const t_word *)s)[0]; ((t_word *)d)[1] = ((const t_word *)s)[1];
+			((t_word *)d)[2] = ((const t_word *)s)[2]; ((t_word *)d)[3] = ((const t_word *)s)[3];
+		}
+		for (; n >= 8; n -= 8, d += 8, s += 8) *(t_word *)d = *(const t_word *)s;
+		while (n--) *d++ = *s++;
+
+		return (dst);
+	}
+
 #pragma endregion
 
-#pragma region "MEMCPY"
+#ifdef MEM_X86
+
+#pragma region "SSE2"
+
+	__attribute__((target("sse2")))
+	static void *memset_sse2(void *b, int c, size_t len) {
+		if (len < 64) return (memset_word(b, c, len));
+
+		unsigned char	*p = b;
+		__m128i			v = _mm_set1_epi8((char)c);
+
+		_mm_storeu_si128((__m128i *)p, v);
+		size_t head = 16 - ((uintptr_t)p & 15);
+		p += head; len -= head;
+
+		if (len >= MEM_NT_THRESHOLD) {
+			for (; len >= 64; len -= 64, p += 64) {
+				_mm_stream_si128((__m128i *)p, v);			_mm_stream_si128((__m128i *)(p + 16), v);
+				_mm_stream_si128((__m128i *)(p + 32), v);	_mm_stream_si128((__m128i *)(p + 48), v);
+			}
+			_mm_sfence();
+		}
+		for (; len >= 16; len -= 16, p += 16) _mm_store_si128((__m128i *)p, v);
+		if (len) _mm_storeu_si128((__m128i *)(p + len - 16), v);
+
+		return (b);
+	}
+
+	__attribute__((target("sse2")))
+	static void *memcpy_sse2(void *dst, const void *src, size_t n) {
+		if (n < 64) return (memcpy_word(dst, src, n));
+
+		unsigned char		*d = dst;
+		const unsigned char	*s = src;
+
+		_mm_storeu_si128((__m128i *)d, _mm_loadu_si128((const __m128i *)s));
+		size_t head = 16 - ((uintptr_t)d & 15);
+		d += head; s += head; n -= head;
+
+		if (n >= MEM_NT_THRESHOLD) {
+			for (; n >= 64; n -= 64, d += 64, s += 64) {
+				__m128i a = _mm_loadu_si128((const __m128i *)s),		b = _mm_loadu_si128((const __m128i *)(s + 16));
+				__m128i e = _mm_loadu_si128((const __m128i *)(s + 32)),	f = _mm_loadu_si128((const __m128i *)(s + 48));
+				_mm_stream_si128((__m128i *)d, a);			_mm_stream_si128((__m128i *)(d + 16), b);
+				_mm_stream_si128((__m128i *)(d + 32), e);	_mm_stream_si128((__m128i *)(d + 48), f);
+			}
+			_mm_sfence();
+		}
+		for (; n >= 16; n -= 16, d += 16, s += 16) _mm_store_si128((__m128i *)d, _mm_loadu_si128((const __m128i *)s));
+		if (n) _mm_storeu_si128((__m128i *)(d + n - 16), _mm_loadu_si128((const __m128i *)(s + n - 16)));
+
+		return (dst);
+	}
+
+#pragma endregion
+
+#pragma region "AVX2"
+
+	__attribute__((target("avx2")))
+	static void *memset_avx2(void *b, int c, size_t len) {
+		if (len < 128) return (memset_sse2(b, c, len));
+
+		unsigned char	*p = b;
+		__m256i			v = _mm256_set1_epi8((char)c);
+
+		_mm256_storeu_si256((__m256i *)p, v);
+		size_t head = 32 - ((uintptr_t)p & 31);
+		p += head; len -= head;
+
+		if (len >= MEM_NT_THRESHOLD) {
+			for (; len >= 128; len -= 128, p += 128) {
+				_mm256_stream_si256((__m256i *)p, v);			_mm256_stream_si256((__m256i *)(p + 32), v);
+				_mm256_stream_si256((__m256i *)(p + 64), v);	_mm256_stream_si256((__m256i *)(p + 96), v);
+			}
+			_mm_sfence();
+		}
+		for (; len >= 32; len -= 32, p += 32) _mm256_store_si256((__m256i *)p, v);
+		if (len) _mm256_storeu_si256((__m256i *)(p + len - 32), v);
 
-	void *ft_memcpy(void *dst, const void *src, int n) {
-		unsigned char		*d = (unsigned char *)dst;
-		const unsigned char	*s = (const unsigned char *)src;
+		return (b);
+	}
 
-		if (!n || (!d && !s && n)) return (dst);
-		while (n-- > 0) *d++ = *s++;
+	__attribute__((target("avx2")))
+	static void *memcpy_avx2(void *dst, const void *src, size_t n) {
+		if (n < 128) return (memcpy_sse2(dst, src, n));
+
+		unsigned char		*d = dst;
+		const unsigned char	*s = src;
+
+		_mm256_storeu_si256((__m256i *)d, _mm256_loadu_si256((const __m256i *)s));
+		size_t head = 32 - ((uintptr_t)d & 31);
+		d += head; s += head; n -= head;
+
+		if (n >= MEM_NT_THRESHOLD) {
+			for (; n >= 128; n -= 128, d += 128, s += 128) {
+				__m256i a = _mm256_loadu_si256((const __m256i *)s),			b = _mm256_loadu_si256((const __m256i *)(s + 32));
+				__m256i e = _mm256_loadu_si256((const __m256i *)(s + 64)),	f = _mm256_loadu_si256((const __m256i *)(s + 96));
+				_mm256_stream_si256((__m256i *)d, a);			_mm256_stream_si256((__m256i *)(d + 32), b);
+				_mm256_stream_si256((__m256i *)(d + 64), e);	_mm256_stream_si256((__m256i *)(d + 96), f);
+			}
+			_mm_sfence();
+		}
+		for (; n >= 32; n -= 32, d += 32, s += 32) _mm256_store_si256((__m256i *)d, _mm256_loadu_si256((const __m256i *)s));
+		if (n) _mm256_storeu_si256((__m256i *)(d + n - 32), _mm256_loadu_si256((const __m256i *)(s + n - 32)));
 
 		return (dst);
 	}
 
 #pragma endregion
+
+#endif
+
+#pragma region "Dispatch"
+
+	void ft_mem_initialize() {
+		void *(*set)(void *, int, size_t) = memset_word;
+		void *(*cpy)(void *, const void *, size_t) = memcpy_word;
+
+		#ifdef MEM_X86
+			__builtin_cpu_init();
+			if (__builtin_cpu_supports("sse2"))	{ set = memset_sse2; cpy = memcpy_sse2; }
+			if (__builtin_cpu_supports("avx2"))	{ set = memset_avx2; cpy = memcpy_avx2; }
+		#endif
+
+		__atomic_store_n(&memset_kernel, set, __ATOMIC_RELAXED);
+		__atomic_store_n(&memcpy_kernel, cpy, __ATOMIC_RELAXED);
+	}
+
+#pragma endregion
+
+#pragma region "MEMSET"
+
+	void *ft_memset(void *b, int c, size_t len) {
+		void *(*kernel)(void *, int, size_t) = __atomic_load_n(&memset_kernel, __ATOMIC_RELAXED);
+
+		if (!kernel) kernel = memset_word;
+		return (kernel(b, c, len));
+	}
+
+#pragma endregion
+
+#pragma region "MEMCPY"
+
+	void *ft_memcpy(void *dst, const void *src, size_t n) {
+		if (!n || (!dst && !src)) return (dst);
+
+		void *(*kernel)(void *, const void *, size_t) = __atomic_load_n(&memcpy_kernel, __ATOMIC_RELAXED);
+
+		if (!kernel) kernel = memcpy_word;
+		return (kernel(dst, src, n));
+	}
+
+#pragma endregion
+
+#pragma region "Information"
+
+	// Memory kernels used by the allocator (calloc zeroing, PERTURB fills and moving reallocs).
+	//
+	//   • ft_mem_initialize() picks the widest kernel the CPU supports (AVX2, SSE2 or 64-bit words) once, at init.
+	//   • Until then (and on other architectures) the word kernels are used.
+	//   • The destination is aligned first, so the main loop uses aligned stores. The tail is done with one
+	//     unaligned store that overlaps the last aligned one.
+	//   • From MEM_NT_THRESHOLD bytes the SIMD kernels use non-temporal stores, so a huge fill or copy does not
+	//     evict the whole cache.
+	//
+	// Notes:
+	//   • The regions must not overlap (same as memcpy).
+	//   • tester/tests/mem_bench.c compares these kernels with the ones from libc.
+
+#pragma endregion
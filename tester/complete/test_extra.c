@@ -17,6 +17,8 @@
 #include <stdint.h>
 #include <errno.h>
 #include <malloc.h>
+#include <sys/wait.h>
+#include <pthread.h>
 
 // Function declarations for our custom malloc functions
 extern void *reallocarray(void *ptr, size_t nmemb, size_t size);
@@ -24,6 +26,15 @@ extern size_t malloc_usable_size(void *ptr);
 extern void *memalign(size_t alignment, size_t size);
 extern void *aligned_alloc(size_t alignment, size_t size);
 
+// Only in ft_malloc (weak, so the tests still link without it)
+extern size_t malloc_batch(size_t size, size_t n, void **out) __attribute__((weak));
+extern void free_batch(void **ptrs, size_t n) __attribute__((weak));
+extern void free_sized(void *ptr, size_t size) __attribute__((weak));
+extern void free_aligned_sized(void *ptr, size_t alignment, size_t size) __attribute__((weak));
+extern struct mallinfo2 mallinfo2() __attribute__((weak));
+extern int malloc_info(int options, FILE *stream) __attribute__((weak));
+extern int malloc_profile_dump(const char *path) __attribute__((weak));
+
 // Test colors
 #define RED     "\033[0;31m"
 #define GREEN   "\033[0;32m"
@@ -229,6 +240,271 @@ void test_malloc_usable_size() {
     }
 }
 
+static void *batch_thread(void *arg) {
+    void **ptrs = (void **)arg;
+
+    for (int i = 0; i < 32; i++) ptrs[i] = malloc(100);
+    return NULL;
+}
+
+void test_batch() {
+    printf(CYAN "\n=== Testing malloc_batch() / free_batch() ===" NC "\n");
+
+    if (!malloc_batch || !free_batch || !mallinfo2) {
+        printf(YELLOW "- " NC "malloc_batch() not available (skipped)\n");
+        return;
+    }
+
+    // Test 1: Different sizes (TINY, SMALL, MEDIUM, LARGE)
+    size_t sizes[] = {16, 100, 1000, 50000, 500000};
+    int batch_ok = 1;
+    int distinct_ok = 1;
+
+    for (int s = 0; s < 5; s++) {
+        void *ptrs[64];
+        size_t count = malloc_batch(sizes[s], 64, ptrs);
+        if (count != 64) { batch_ok = 0; break; }
+
+        for (int i = 0; i < 64; i++) memset(ptrs[i], i, sizes[s]);
+        for (int i = 0; i < 64; i++) {
+            unsigned char *bytes = (unsigned char*)ptrs[i];
+            if (bytes[0] != (unsigned char)i || bytes[sizes[s] - 1] != (unsigned char)i) distinct_ok = 0;
+        }
+
+        free_batch(ptrs, 64);
+    }
+    test_assert(batch_ok, "malloc_batch() allocates all blocks");
+    test_assert(distinct_ok, "malloc_batch() blocks do not overlap");
+
+    // Test 2: Zero blocks
+    test_assert(malloc_batch(100, 0, NULL) == 0, "malloc_batch(size, 0, NULL) returns 0");
+
+    // Test 3: Mixed pointers (NULL entries and blocks from malloc), released without the thread cache
+    void *mixed[4] = { malloc(32), NULL, malloc(3000), calloc(10, 10) };
+    struct mallinfo2 during = mallinfo2();
+    free_batch(mixed, 4);
+    struct mallinfo2 after = mallinfo2();
+    test_assert(after.uordblks + 32 + 3000 + 100 <= during.uordblks, "free_batch() with NULL entries and mixed blocks");
+
+    // Test 4: Blocks from malloc_batch can be freed one by one
+    void *single[8];
+    if (malloc_batch(200, 8, single) == 8) {
+        for (int i = 0; i < 8; i++) free(single[i]);
+        void *ptr = malloc(200);
+        int reused = 0;
+        for (int i = 0; i < 8; i++) if (ptr == single[i]) reused = 1;
+        test_assert(reused, "malloc_batch() blocks can be released with free()");
+        free(ptr);
+    } else {
+        test_assert(0, "malloc_batch() blocks can be released with free()");
+    }
+
+    // Test 5: Double free of a block held in the thread cache (in a child, the default action aborts)
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(STDERR_FILENO);
+        void *ptr = malloc(16);
+        free(ptr);
+        free_batch(&ptr, 1);
+
+        // Not aborted (MALLOC_CHECK_), the block must not be handed out twice
+        int count = 0;
+        for (int i = 0; i < 64; i++) if (malloc(16) == ptr) count++;
+        _exit(count > 1);
+    }
+    int status = 0;
+    if (pid > 0) waitpid(pid, &status, 0);
+    test_assert(pid > 0 && (WIFSIGNALED(status) || WEXITSTATUS(status) == 0), "free_batch() detects a double free of a cached block");
+
+    // Test 6: Pointers of two arenas interleaved (blocks of another thread)
+    void *own[32], *other[32] = {0}, *interleaved[64];
+    pthread_t thread;
+    int threads_ok = !pthread_create(&thread, NULL, batch_thread, other) && !pthread_join(thread, NULL);
+    for (int i = 0; i < 32; i++) {
+        own[i] = malloc(100);
+        if (!own[i] || !other[i]) threads_ok = 0;
+        interleaved[i * 2] = own[i];
+        interleaved[i * 2 + 1] = other[i];
+    }
+    during = mallinfo2();
+    free_batch(interleaved, 64);
+    after = mallinfo2();
+    test_assert(threads_ok && after.uordblks + 64 * 100 <= during.uordblks, "free_batch() with pointers of two arenas interleaved");
+}
+
+void test_stats() {
+    printf(CYAN "\n=== Testing mallinfo2() / malloc_info() ===" NC "\n");
+
+    if (!mallinfo2 || !malloc_info) {
+        printf(YELLOW "- " NC "mallinfo2() not available (skipped)\n");
+        return;
+    }
+
+    // Test 1: Bytes in use follow the allocations and frees
+    struct mallinfo2 before = mallinfo2();
+    void *ptrs[4];
+    for (int i = 0; i < 4; i++) ptrs[i] = malloc(500000);
+    struct mallinfo2 during = mallinfo2();
+    for (int i = 0; i < 4; i++) free(ptrs[i]);
+    struct mallinfo2 after = mallinfo2();
+
+    test_assert(during.uordblks >= before.uordblks + 4 * 500000, "mallinfo2() counts the bytes in use");
+    test_assert(after.uordblks + 4 * 500000 <= during.uordblks, "mallinfo2() discounts the freed bytes");
+    test_assert(during.arena + during.hblkhd >= during.uordblks, "mallinfo2() maps at least the bytes in use");
+
+    // Test 2: XML dump
+    FILE *stream = tmpfile();
+    char buffer[64] = {0};
+    if (stream) {
+        test_assert(malloc_info(0, stream) == 0, "malloc_info() returns 0");
+        rewind(stream);
+        if (!fgets(buffer, sizeof(buffer), stream)) buffer[0] = '\0';
+        test_assert(strncmp(buffer, "<malloc version=\"1\">", 20) == 0, "malloc_info() writes the <malloc> element");
+        fclose(stream);
+    }
+
+    // Test 3: Invalid options
+    test_assert(malloc_info(1, stdout) != 0, "malloc_info(1, stream) fails");
+}
+
+void test_profile() {
+    printf(CYAN "\n=== Testing malloc_profile_dump() ===" NC "\n");
+
+    if (!malloc_profile_dump) {
+        printf(YELLOW "- " NC "malloc_profile_dump() not available (skipped)\n");
+        return;
+    }
+
+    // Test 1: Invalid path
+    test_assert(malloc_profile_dump(NULL) == -1 && errno == EINVAL, "malloc_profile_dump(NULL) fails with EINVAL");
+
+    // Test 2: Disabled (MALLOC_PROFILE can only be set before the first allocation)
+    char path[] = "/tmp/test_profile_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd == -1) return;
+    close(fd);
+
+    if (!getenv("MALLOC_PROFILE") || !atoi(getenv("MALLOC_PROFILE"))) {
+        test_assert(malloc_profile_dump(path) == -1 && errno == EINVAL, "malloc_profile_dump() fails when MALLOC_PROFILE is disabled");
+        unlink(path);
+        return;
+    }
+
+    // Test 3: Live samples stay in the profile until they are freed
+    void *ptrs[64];
+    for (int i = 0; i < 64; i++) ptrs[i] = malloc(100000);
+    test_assert(malloc_profile_dump(path) == 0, "malloc_profile_dump() returns 0");
+
+    FILE *stream = fopen(path, "r");
+    char buffer[256] = {0};
+    unsigned long live = 0, live_bytes = 0;
+    if (stream) {
+        if (!fgets(buffer, sizeof(buffer), stream)) buffer[0] = '\0';
+        fclose(stream);
+    }
+    test_assert(sscanf(buffer, "heap profile: %lu: %lu [", &live, &live_bytes) == 2, "malloc_profile_dump() writes a heap profile header");
+    test_assert(live > 0 && live_bytes >= 100000, "malloc_profile_dump() has live samples");
+
+    for (int i = 0; i < 64; i++) free(ptrs[i]);
+    unlink(path);
+}
+
+void test_free_sized() {
+    printf(CYAN "\n=== Testing free_sized() / free_aligned_sized() ===" NC "\n");
+
+    if (!free_sized || !free_aligned_sized || !mallinfo2) {
+        printf(YELLOW "- " NC "free_sized() not available (skipped)\n");
+        return;
+    }
+
+    // Test 1: Different sizes (TINY, SMALL, MEDIUM, LARGE), reused after being freed
+    size_t sizes[] = {8, 100, 128, 1000, 2048, 50000, 500000};
+    int reuse_ok = 1;
+
+    for (int s = 0; s < 7; s++) {
+        void *ptrs[32];
+        for (int round = 0; round < 2; round++) {
+            for (int i = 0; i < 32; i++) {
+                ptrs[i] = malloc(sizes[s]);
+                if (!ptrs[i]) { reuse_ok = 0; continue; }
+                memset(ptrs[i], i, sizes[s]);
+            }
+            for (int i = 0; i < 32; i++) {
+                unsigned char *bytes = (unsigned char*)ptrs[i];
+                if (bytes && (bytes[0] != (unsigned char)i || bytes[sizes[s] - 1] != (unsigned char)i)) reuse_ok = 0;
+                free_sized(ptrs[i], sizes[s]);
+            }
+        }
+    }
+    test_assert(reuse_ok, "free_sized() releases blocks of every size");
+
+    // Test 2: NULL pointer and malloc(0) release nothing
+    struct mallinfo2 before = mallinfo2();
+    free_sized(NULL, 100);
+    free_sized(malloc(0), 0);
+    struct mallinfo2 after = mallinfo2();
+    test_assert(after.uordblks == before.uordblks, "free_sized() with NULL and malloc(0)");
+
+    // Test 3: Shrunk block (the size does not match the chunk), reused by the next allocation of that size
+    void *ptr1 = malloc(1000);
+    void *ptr2 = ptr1 ? realloc(ptr1, 200) : NULL;
+    if (ptr2) {
+        free_sized(ptr2, 200);
+        void *ptr3 = malloc(200);
+        test_assert(ptr3 == ptr2, "free_sized() after realloc() to a smaller size");
+        free(ptr3);
+    } else {
+        free(ptr1);
+        test_assert(0, "free_sized() after realloc() to a smaller size");
+    }
+
+    // Test 4: Aligned blocks
+    int aligned_ok = 1;
+    for (int i = 0; i < 32; i++) {
+        void *ptr = aligned_alloc(64, 64 * (i + 1));
+        if (!ptr || (uintptr_t)ptr % 64) { aligned_ok = 0; free(ptr); continue; }
+        free_aligned_sized(ptr, 64, 64 * (i + 1));
+    }
+    test_assert(aligned_ok, "free_aligned_sized() releases aligned blocks");
+
+    // Test 5: Pointer inside a TINY block (in a child, the default action aborts)
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(STDERR_FILENO);
+        char *ptr = malloc(32);
+        free_sized(ptr + 16, 32);
+
+        // Not aborted (MALLOC_CHECK_), the inner pointer must not be handed out
+        int count = 0;
+        for (int i = 0; i < 64; i++) if (malloc(32) == ptr + 16) count++;
+        _exit(count > 0);
+    }
+    int status = 0;
+    if (pid > 0) waitpid(pid, &status, 0);
+    test_assert(pid > 0 && (WIFSIGNALED(status) || WEXITSTATUS(status) == 0), "free_sized() rejects a pointer inside a TINY block");
+
+    // Test 6: Double free of a TINY block already released (in a child, the default action aborts)
+    if (!free_batch) return;
+    fflush(stdout);
+    pid = fork();
+    if (pid == 0) {
+        close(STDERR_FILENO);
+        void *ptr = malloc(32);
+        free_batch(&ptr, 1);
+        free_sized(ptr, 32);
+
+        // Not aborted (MALLOC_CHECK_), the block must not be handed out twice
+        int count = 0;
+        for (int i = 0; i < 64; i++) if (malloc(32) == ptr) count++;
+        _exit(count > 1);
+    }
+    status = 0;
+    if (pid > 0) waitpid(pid, &status, 0);
+    test_assert(pid > 0 && (WIFSIGNALED(status) || WEXITSTATUS(status) == 0), "free_sized() detects a double free of a TINY block");
+}
+
 void test_edge_cases() {
     printf(CYAN "\n=== Testing edge cases ===" NC "\n");
     
@@ -414,6 +690,10 @@ void test_integration_extra() {
 int main() {
     test_reallocarray();
     test_malloc_usable_size();
+    test_batch();
+    test_free_sized();
+    test_stats();
+    test_profile();
     test_edge_cases();
     test_integration_extra();
 }
@@ -160,6 +160,23 @@ void test_free_basic() {
         if (ptrs[i]) free(ptrs[i]);
     }
     test_assert(1, "Multiple free() calls don't crash");
+
+    // Test 4: TINY blocks have no header, so any value in them is user data (even the POISON pattern)
+    uint64_t *tiny = malloc(16);
+    if (tiny) {
+        tiny[0] = 0;
+        tiny[1] = 0xDEADBEEFCAFEBABEULL;
+        free(tiny);
+        uint64_t *reused = malloc(16);
+        test_assert(reused == tiny, "free() releases a 16-byte block that holds the POISON pattern");
+
+        if (reused) {
+            reused[1] = 0xDEADBEEFCAFEBABEULL;
+            uint64_t *grown = realloc(reused, 100);
+            test_assert(grown && grown[1] == 0xDEADBEEFCAFEBABEULL, "realloc() moves a 16-byte block that holds the POISON pattern");
+            free(grown);
+        }
+    }
 }
 
 void test_calloc_basic() {
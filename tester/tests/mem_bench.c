@@ -0,0 +1,135 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   mem_bench.c                                        :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vzurera- <vzurera-@student.42malaga.com    +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 14:02:51 by vzurera-          #+#    #+#             */
+/*   Updated: 2026/10/17 14:02:51 by vzurera-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+// Microbenchmark of ft_memset / ft_memcpy against a byte loop and libc.
+//
+//   gcc -O2 -Wno-unknown-pragmas -I../../inc mem_bench.c ../../src/utils/mem.c -o mem_bench && ./mem_bench
+
+#pragma region "Includes"
+
+	#include <stdio.h>
+	#include <stdlib.h>
+	#include <string.h>
+	#include <time.h>
+
+	#include "utils.h"
+
+#pragma endregion
+
+#pragma region "Defines"
+
+	#define MAX_SIZE	(64 * 1024 * 1024)
+	#define MIN_BYTES	(512 * 1024 * 1024)
+
+#pragma endregion
+
+#pragma region "Reference"
+
+	__attribute__((noinline, optimize("no-tree-loop-distribute-patterns")))
+	static void *byte_memset(void *b, int c, size_t len) {
+		volatile unsigned char *p = b;
+
+		while (len--) *p++ = (unsigned char)c;
+		return (b);
+	}
+
+	__attribute__((noinline, optimize("no-tree-loop-distribute-patterns")))
+	static void *byte_memcpy(void *dst, const void *src, size_t n) {
+		volatile unsigned char	*d = dst;
+		const unsigned char		*s = src;
+
+		while (n--) *d++ = *s++;
+		return (dst);
+	}
+
+#pragma endregion
+
+#pragma region "Timing"
+
+	static double now() {
+		struct timespec ts;
+
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		return (ts.tv_sec + ts.tv_nsec / 1e9);
+	}
+
+	static double bench_set(void *(*fn)(void *, int, size_t), char *buf, size_t size) {
+		size_t	rounds = (MIN_BYTES / size) + 1;
+		double	start = now();
+
+		for (size_t i = 0; i < rounds; ++i) fn(buf + (i & 7), (int)i, size);
+		return ((double)rounds * size / (now() - start) / 1e9);
+	}
+
+	static double bench_cpy(void *(*fn)(void *, const void *, size_t), char *dst, const char *src, size_t size) {
+		size_t	rounds = (MIN_BYTES / size) + 1;
+		double	start = now();
+
+		for (size_t i = 0; i < rounds; ++i) fn(dst + (i & 7), src, size);
+		return ((double)rounds * size / (now() - start) / 1e9);
+	}
+
+#pragma endregion
+
+#pragma region "Check"
+
+	static int check(char *dst, char *src) {
+		for (size_t size = 0; size < 4096; size += (size < 300) ? 1 : 97) {
+			for (size_t offset = 0; offset < 32; offset += 7) {
+				memset(dst, 0x55, size + 64);
+				ft_memset(dst + offset, 0xAB, size);
+				for (size_t i = 0; i < size + 64; ++i) {
+					char expected = (i >= offset && i < offset + size) ? (char)0xAB : 0x55;
+					if (dst[i] != expected) return (printf("ft_memset failed (size %zu, offset %zu)\n", size, offset), 1);
+				}
+
+				memset(dst, 0x55, size + 64);
+				ft_memcpy(dst + offset, src + 3, size);
+				if (memcmp(dst + offset, src + 3, size) || dst[offset + size] != 0x55)
+					return (printf("ft_memcpy failed (size %zu, offset %zu)\n", size, offset), 1);
+			}
+		}
+
+		return (0);
+	}
+
+#pragma endregion
+
+#pragma region "Main"
+
+	int main() {
+		char *dst = aligned_alloc(64, MAX_SIZE + 64);
+		char *src = aligned_alloc(64, MAX_SIZE + 64);
+		if (!dst || !src) return (1);
+
+		for (size_t i = 0; i < MAX_SIZE + 64; ++i) src[i] = (char)(i * 31);
+
+		ft_mem_initialize();
+		if (check(dst, src)) return (1);
+
+		size_t sizes[] = { 64, 256, 4096, 65536, 1024 * 1024, 16 * 1024 * 1024, MAX_SIZE };
+
+		printf("%10s  %27s  %27s\n", "", "memset (GB/s)", "memcpy (GB/s)");
+		printf("%10s  %8s %8s %8s  %8s %8s %8s\n", "size", "byte", "ft", "libc", "byte", "ft", "libc");
+		for (size_t i = 0; i < sizeof(sizes) / sizeof(*sizes); ++i) {
+			size_t size = sizes[i];
+			printf("%10zu  %8.2f %8.2f %8.2f  %8.2f %8.2f %8.2f\n", size,
+				bench_set(byte_memset, dst, size), bench_set(ft_memset, dst, size), bench_set(memset, dst, size),
+				bench_cpy(byte_memcpy, dst, src, size), bench_cpy(ft_memcpy, dst, src, size), bench_cpy(memcpy, dst, src, size));
+		}
+
+		free(dst);
+		free(src);
+		return (0);
+	}
+
+#pragma endregion
@@ -0,0 +1,205 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   trace_decode.c                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vzurera- <vzurera-@student.42malaga.com    +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 21:52:07 by vzurera-          #+#    #+#             */
+/*   Updated: 2026/10/17 21:52:07 by vzurera-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+// Decoder of the binary trace written with MALLOC_TRACING (prints the events with the format of the log).
+//
+//   gcc -O2 -Wno-unknown-pragmas -I../../inc trace_decode.c -o trace_decode && ./trace_decode [-v] /tmp/malloc_[PID].trace
+
+#pragma region "Includes"
+
+	#include <stdio.h>
+	#include <stdlib.h>
+	#include <string.h>
+
+	#include "internal.h"
+
+#pragma endregion
+
+#pragma region "Defines"
+
+	#define MAP_SIZE	(1 << 20)
+
+#pragma endregion
+
+#pragma region "Variables"
+
+	typedef struct {
+		uint64_t	ptr;
+		uint64_t	size;
+	} t_entry;
+
+	static t_entry	*map;
+	static size_t	map_size = MAP_SIZE;
+	static size_t	map_used;
+
+#pragma endregion
+
+#pragma region "Sizes"
+
+	// Frees are recorded without size, so the size of each live pointer is kept here (open addressing)
+	static size_t map_slot(t_entry *entries, size_t size, uint64_t ptr) {
+		size_t i = (ptr >> 4) * 0x9E3779B97F4A7C15ULL & (size - 1);
+
+		while (entries[i].ptr && entries[i].ptr != ptr) i = (i + 1) & (size - 1);
+		return (i);
+	}
+
+	static void map_set(uint64_t ptr, uint64_t size) {
+		if (!ptr) return ;
+
+		if (map_used * 2 >= map_size) {
+			t_entry *entries = calloc(map_size * 2, sizeof(t_entry));
+			if (!entries) { perror("calloc"); exit(1); }
+			for (size_t i = 0; i < map_size; ++i)
+				if (map[i].ptr) entries[map_slot(entries, map_size * 2, map[i].ptr)] = map[i];
+			free(map);
+			map = entries;
+			map_size *= 2;
+		}
+
+		size_t i = map_slot(map, map_size, ptr);
+		if (!map[i].ptr) map_used++;
+		map[i].ptr = ptr;
+		map[i].size = size;
+	}
+
+	static uint64_t map_take(uint64_t ptr) {
+		size_t		i = map_slot(map, map_size, ptr);
+		uint64_t	size = map[i].size;
+
+		if (!map[i].ptr) return (0);
+
+		// Backward shift, so the probe chains stay valid without tombstones
+		map[i].ptr = 0;
+		map_used--;
+		for (size_t j = (i + 1) & (map_size - 1); map[j].ptr; j = (j + 1) & (map_size - 1)) {
+			t_entry entry = map[j];
+			map[j].ptr = 0;
+			map[map_slot(map, map_size, entry.ptr)] = entry;
+		}
+
+		return (size);
+	}
+
+#pragma endregion
+
+#pragma region "Read"
+
+	static t_trace_event *read_trace(const char *path, size_t *count) {
+		FILE			*file = fopen(path, "rb");
+		t_trace_header	header;
+
+		if (!file) return (perror(path), NULL);
+		if (fread(&header, sizeof(header), 1, file) != 1 || memcmp(header.magic, TRACE_MAGIC, sizeof(header.magic))) {
+			fprintf(stderr, "%s: not a malloc trace\n", path);
+			return (fclose(file), NULL);
+		}
+		if (header.version != TRACE_VERSION || header.event_size != sizeof(t_trace_event)) {
+			fprintf(stderr, "%s: unsupported trace (version %u, event of %u bytes)\n", path, header.version, header.event_size);
+			return (fclose(file), NULL);
+		}
+
+		size_t			capacity = 65536;
+		t_trace_event	*events = malloc(capacity * sizeof(t_trace_event));
+
+		*count = 0;
+		while (events) {
+			*count += fread(&events[*count], sizeof(t_trace_event), capacity - *count, file);
+			if (*count < capacity) break;
+
+			t_trace_event *bigger = realloc(events, capacity * 2 * sizeof(t_trace_event));
+			if (!bigger) { free(events); events = NULL; break; }
+			events = bigger;
+			capacity *= 2;
+		}
+
+		if (!events) perror("malloc");
+		fclose(file);
+		return (events);
+	}
+
+	// Blocks of different threads are interleaved in the file, so the events are sorted by time (stable for equal ticks)
+	static int compare_events(const void *a, const void *b) {
+		const t_trace_event *first = *(t_trace_event **)a, *second = *(t_trace_event **)b;
+
+		if (first->tsc != second->tsc) return ((first->tsc < second->tsc) ? -1 : 1);
+		return ((first < second) ? -1 : (first > second));
+	}
+
+#pragma endregion
+
+#pragma region "Print"
+
+	static void print_event(t_trace_event *event, int verbose) {
+		static const char	*sources[] = TRACE_SOURCES;
+		static const char	*types[] = { "TINY", "SMALL", "MEDIUM", "LARGE" };
+		const char			*source = (event->info < sizeof(sources) / sizeof(*sources)) ? sources[event->info] : sources[0];
+		const char			*type = (event->info < sizeof(types) / sizeof(*types)) ? types[event->info] : "UNKOWN";
+		uint64_t			size = event->size;
+
+		if (verbose) printf("%20lu %8u %4u %14lx  ", event->tsc, event->thread, event->arena, event->heap);
+
+		switch (event->op) {
+			case TRACE_ALLOC:
+				map_set(event->ptr, size);
+				printf("0x%lx\t [%s] Allocated %lu bytes\n", event->ptr, source, size);											break;
+			case TRACE_FREE:
+				if (!size)	size = map_take(event->ptr);
+				else		map_take(event->ptr);
+				printf("0x%lx\t   [FREE] Memory freed of size %lu bytes\n", event->ptr, size);										break;
+			case TRACE_EXTEND:
+				map_set(event->ptr, size);
+				printf("0x%lx\t [%s] Extended to %lu bytes\n", event->ptr, source, size);										break;
+			case TRACE_SHRINK:
+				map_set(event->ptr, size);
+				printf("0x%lx\t [%s] Shrunk to %lu bytes\n", event->ptr, source, size);											break;
+			case TRACE_SAME:
+				map_set(event->ptr, size);
+				printf("0x%lx\t [%s] Size unchanged %lu bytes\n", event->ptr, source, size);										break;
+			case TRACE_HEAP_CREATE:
+				printf("0x%lx\t [SYSTEM] Heap of size %s (%lu) allocated\n", event->ptr, type, size);								break;
+			case TRACE_HEAP_FREE:
+				printf("0x%lx\t [SYSTEM] Heap of size %s (%lu) freed\n", event->ptr, type, size);									break;
+			default:
+				printf("0x%lx\t [UNKOWN] Event %u\n", event->ptr, event->op);															break;
+		}
+	}
+
+#pragma endregion
+
+#pragma region "Main"
+
+	int main(int argc, char **argv) {
+		int verbose = (argc > 1 && !strcmp(argv[1], "-v"));
+
+		if (argc != 2 + verbose) return (fprintf(stderr, "usage: %s [-v] trace_file\n", argv[0]), 1);
+
+		size_t			count;
+		t_trace_event	*events = read_trace(argv[1 + verbose], &count);
+		if (!events) return (1);
+		if (!(map = calloc(map_size, sizeof(t_entry)))) return (perror("calloc"), 1);
+
+		t_trace_event **order = malloc((count + 1) * sizeof(t_trace_event *));
+		if (!order) return (perror("malloc"), 1);
+		for (size_t i = 0; i < count; ++i) order[i] = &events[i];
+
+		qsort(order, count, sizeof(t_trace_event *), compare_events);
+		if (verbose) printf("%20s %8s %4s %14s  %s\n", "tsc", "thread", "arena", "heap", "event");
+		for (size_t i = 0; i < count; ++i) print_event(order[i], verbose);
+
+		free(order);
+		free(events);
+		free(map);
+		return (0);
+	}
+
+#pragma endregion